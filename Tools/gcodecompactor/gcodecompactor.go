@@ -0,0 +1,206 @@
+package main
+
+import (
+	"bufio"
+	"bytes"
+	"flag"
+	"fmt"
+	"io/ioutil"
+	"log"
+	"math"
+	"os"
+	"strings"
+)
+
+// These must match src/GCodes/CompactGCode.h
+const (
+	signature        = ";RepRapFirmware compact G-code 2\n"
+	moveRecordFlag   = 0x80
+	g1Flag           = 0x40
+	varintByteFlag   = 0x80
+	varintMoreFlag   = 0x40
+	varintPayload    = 0x3F
+	parameterLetters = "XYZEF"
+	numParameters    = len(parameterLetters)
+)
+
+// The scale for each parameter is 10 to the power of the number of decimals
+var parameterDecimals = [numParameters]int{3, 3, 3, 5, 1}
+
+func main() {
+	inFile := flag.String("in", "", "Path to the G-code file to convert")
+	outFile := flag.String("out", "", "Path to write the compact G-code file to")
+	flag.Parse()
+
+	if *inFile == "" || *outFile == "" {
+		log.Fatal("-in and -out need to be provided")
+	}
+
+	input, err := ioutil.ReadFile(*inFile)
+	if err != nil {
+		log.Fatal(err)
+	}
+	if bytes.HasPrefix(input, []byte(signature)) {
+		log.Fatal("input file is already in compact format")
+	}
+
+	f, err := os.Create(*outFile)
+	if err != nil {
+		log.Fatal(err)
+	}
+	defer f.Close()
+	w := bufio.NewWriter(f)
+
+	if _, err = w.WriteString(signature); err != nil {
+		log.Fatal(err)
+	}
+
+	lines := bytes.Split(input, []byte("\n"))
+	if len(lines) != 0 && len(lines[len(lines)-1]) == 0 {
+		lines = lines[:len(lines)-1] // the file ended with a newline
+	}
+
+	writingFile := false
+	numMoves := 0
+	for lineNumber, line := range lines {
+		line = bytes.TrimSuffix(line, []byte("\r"))
+		if len(line) != 0 && line[0] >= moveRecordFlag {
+			log.Fatalf("line %d starts with a non-ASCII character", lineNumber+1)
+		}
+
+		// Don't compact anything that is being written to a file by M28
+		trimmed := strings.TrimSpace(string(line))
+		if strings.HasPrefix(trimmed, "M28 ") {
+			writingFile = true
+		} else if strings.HasPrefix(trimmed, "M29") {
+			writingFile = false
+		}
+
+		if !writingFile {
+			if record, ok := compactMove(line); ok {
+				if _, err = w.Write(record); err != nil {
+					log.Fatal(err)
+				}
+				numMoves++
+				continue
+			}
+		}
+
+		if _, err = w.Write(line); err != nil {
+			log.Fatal(err)
+		}
+		if err = w.WriteByte('\n'); err != nil {
+			log.Fatal(err)
+		}
+	}
+
+	if err = w.Flush(); err != nil {
+		log.Fatal(err)
+	}
+	info, err := f.Stat()
+	if err != nil {
+		log.Fatal(err)
+	}
+	fmt.Printf("%d lines, %d moves compacted, %d bytes reduced to %d\n", len(lines), numMoves, len(input), info.Size())
+}
+
+// compactMove returns the move record for a line if it is an unindented G0 or G1 command whose only parameters are X, Y, Z, E and F given as plain numbers
+func compactMove(line []byte) ([]byte, bool) {
+	// Anything after a semicolon is a comment
+	if i := bytes.IndexByte(line, ';'); i >= 0 {
+		line = line[:i]
+	}
+	line = bytes.TrimRight(line, " \t")
+
+	var tag byte
+	switch {
+	case bytes.Equal(line, []byte("G0")) || bytes.HasPrefix(line, []byte("G0 ")) || bytes.Equal(line, []byte("G00")) || bytes.HasPrefix(line, []byte("G00 ")):
+		tag = moveRecordFlag
+	case bytes.Equal(line, []byte("G1")) || bytes.HasPrefix(line, []byte("G1 ")) || bytes.Equal(line, []byte("G01")) || bytes.HasPrefix(line, []byte("G01 ")):
+		tag = moveRecordFlag | g1Flag
+	default:
+		return nil, false
+	}
+	line = line[bytes.IndexByte(append(line, ' '), ' '):]
+
+	var values [numParameters]int64
+	for {
+		line = bytes.TrimLeft(line, " \t")
+		if len(line) == 0 {
+			break
+		}
+		index := strings.IndexByte(parameterLetters, line[0])
+		if index < 0 || tag&(1<<uint(index)) != 0 {
+			return nil, false
+		}
+		end := 1
+		for end < len(line) && strings.IndexByte("0123456789.-+", line[end]) >= 0 {
+			end++
+		}
+		if end < len(line) && line[end] != ' ' && line[end] != '\t' {
+			// The firmware would treat E directly after a digit as an exponent, and anything else is not a plain number
+			return nil, false
+		}
+		value, ok := parseFixedPoint(string(line[1:end]), parameterDecimals[index])
+		if !ok {
+			return nil, false
+		}
+		tag |= 1 << uint(index)
+		values[index] = value
+		line = line[end:]
+	}
+
+	record := []byte{tag}
+	for i := 0; i < numParameters; i++ {
+		if tag&(1<<uint(i)) != 0 {
+			record = appendVarint(record, values[i])
+		}
+	}
+	return record, true
+}
+
+// parseFixedPoint converts a plain decimal number to an integer number of units of the last decimal place, provided that it can be done exactly
+func parseFixedPoint(s string, maxDecimals int) (int64, bool) {
+	negative := false
+	if len(s) != 0 && (s[0] == '-' || s[0] == '+') {
+		negative = s[0] == '-'
+		s = s[1:]
+	}
+	intPart, fracPart := s, ""
+	if i := strings.IndexByte(s, '.'); i >= 0 {
+		intPart, fracPart = s[:i], s[i+1:]
+	}
+	if len(intPart)+len(fracPart) == 0 || len(intPart) > 9 {
+		return 0, false
+	}
+	fracPart = strings.TrimRight(fracPart, "0")
+	if len(fracPart) > maxDecimals {
+		return 0, false
+	}
+	fracPart += strings.Repeat("0", maxDecimals-len(fracPart))
+
+	var value int64
+	for _, c := range intPart + fracPart {
+		if c < '0' || c > '9' {
+			return 0, false
+		}
+		value = value*10 + int64(c-'0')
+	}
+	if negative {
+		value = -value
+	}
+	if value > math.MaxInt32 || value < math.MinInt32 {
+		return 0, false
+	}
+	return value, true
+}
+
+// appendVarint appends a zigzag-encoded varint with 6 bits per byte. Every byte has the top bit set so that it can't be mistaken for a newline.
+func appendVarint(b []byte, v int64) []byte {
+	u := uint32((int32(v) << 1) ^ (int32(v) >> 31))
+	for u > varintPayload {
+		b = append(b, byte(u&varintPayload)|varintByteFlag|varintMoreFlag)
+		u >>= 6
+	}
+	return append(b, byte(u)|varintByteFlag)
+}
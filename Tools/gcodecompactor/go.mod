@@ -0,0 +1,3 @@
+module github.com/Duet3D/RepRapFirmware/Tools/gcodecompactor
+
+go 1.15
@@ -71,6 +71,7 @@ constexpr uint32_t AuxTimeout = 2000;					// timeout in ms for PanelDue replies
 
 // Conditional GCode support
 constexpr unsigned int MaxBlockIndent = 10;				// maximum indentation of GCode. Each level of indentation introduced a new block.
+constexpr size_t NumCompiledConditions = 4;				// number of compiled if/while conditions cached per input channel
 
 // Default Z probe values
 
@@ -236,6 +237,10 @@ constexpr uint32_t DefaultIdleTimeout = 30000;			// Milliseconds
 constexpr float DefaultIdleCurrentFactor = 0.3;			// Proportion of normal motor current that we use for idle hold
 
 constexpr uint32_t DefaultGracePeriod = 10;				// how long we wait for more moves to become available before starting movement
+constexpr uint32_t MaxPlannerMoves = 200;				// maximum number of previous moves that the two-pass planner may adjust when a new move is added
+constexpr unsigned int MaxAdaptiveDdaRingLength = 200;	// the main movement queue may grow to this many moves when the moves are very short
+constexpr uint32_t AdaptiveLookaheadTime = 500;			// milliseconds of movement that we try to keep in the movement queue when growing it
+constexpr ptrdiff_t AdaptiveRingRamReserve = 8192;		// don't grow the movement queue if it would leave less than this amount of never-used RAM
 
 constexpr float DefaultNonlinearExtrusionLimit = 0.2;	// Maximum additional commanded extrusion to compensate for nonlinearity
 constexpr size_t NumRestorePoints = 6;					// Number of restore points, must be at least 3
@@ -277,6 +282,15 @@ constexpr size_t MAX_FILES = 10;						// Must be large enough to handle the max
 
 constexpr size_t FILE_BUFFER_SIZE = 128;
 
+constexpr size_t FilePrefetchBlockSize = 2048;			// Size of each of the two blocks used to read ahead in the file being printed. Must be a multiple of 512.
+constexpr uint32_t FilePrefetchMinFileLength = 65536;		// Files shorter than this (e.g. most macros) are read directly without read-ahead
+constexpr size_t MacroCacheNumFiles = 8;				// Number of macro files that we keep in RAM
+constexpr uint32_t MacroCacheMaxFileSize = 2048;		// Macro files longer than this are not cached
+constexpr size_t FileInfoCacheSlots = 256;				// Number of records in the persistent file info cache
+constexpr size_t CancelledObjectMaxSkipBytes = 4096;	// Maximum amount of a cancelled object that we skip before executing the move that replaces it
+constexpr size_t ModelResponseCacheEntries = 4;			// Number of rendered object model responses that we keep for other clients that make the same request
+constexpr uint32_t ModelResponseCacheMaxAge = 200;		// Maximum age in milliseconds of a cached object model response, which limits how stale its live values can be
+
 constexpr size_t MaxThumbnails = 4;						// Maximum number of thumbnail images read from the job file that we store and report
 
 // Webserver stuff
@@ -311,6 +325,8 @@ static_assert(MaxExpectedWebDirFilenameLength + strlen(WEB_DIR) + strlen(".gz")
 
 #define DEFAULT_LOG_FILE "eventlog.txt"
 
+#define FILE_INFO_CACHE_FILE "fileinfo.cache"				// Where we keep the results of parsing G-code files, in the system directory
+
 #define EOF_STRING "<!-- **EoF** -->"
 
 // List defaults
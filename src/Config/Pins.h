@@ -191,6 +191,34 @@
 # define HAS_EMBEDDED_FILES		0
 #endif
 
+#ifndef SUPPORT_FILE_PREFETCH
+# define SUPPORT_FILE_PREFETCH	(HAS_MASS_STORAGE && (SAME70 || SAME5x))
+#endif
+
+#ifndef SUPPORT_COMPACT_GCODE
+# define SUPPORT_COMPACT_GCODE	(HAS_MASS_STORAGE || HAS_EMBEDDED_FILES)
+#endif
+
+#ifndef SUPPORT_MACRO_CACHE
+# define SUPPORT_MACRO_CACHE	(HAS_MASS_STORAGE && (SAME70 || SAME5x))
+#endif
+
+#ifndef SUPPORT_COMPILED_EXPRESSIONS
+# define SUPPORT_COMPILED_EXPRESSIONS	(HAS_MASS_STORAGE)
+#endif
+
+#ifndef SUPPORT_OBJECT_SKIPPING
+# define SUPPORT_OBJECT_SKIPPING	(HAS_MASS_STORAGE && SUPPORT_COMPACT_GCODE)
+#endif
+
+#ifndef SUPPORT_FILE_INFO_CACHE
+# define SUPPORT_FILE_INFO_CACHE	(HAS_MASS_STORAGE)
+#endif
+
+#ifndef SUPPORT_MODEL_RESPONSE_CACHE
+# define SUPPORT_MODEL_RESPONSE_CACHE	(SUPPORT_OBJECT_MODEL && (SAME70 || SAME5x))
+#endif
+
 #if !HAS_MASS_STORAGE && !HAS_SBC_INTERFACE
 # if SUPPORT_12864_LCD
 #  error "12864 LCD support requires mass storage or SBC interface"
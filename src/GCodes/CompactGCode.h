@@ -0,0 +1,58 @@
+/*
+ * CompactGCode.h
+ *
+ *  Created on: 17 Oct 2026
+ *
+ * Definition of the compact G-code print file format.
+ *
+ * A compact G-code file starts with the signature line below. After that it contains a mixture of plain G-code text lines and move records.
+ * Each text line or move record corresponds to exactly one line of the original G-code file, so line numbers in error messages are preserved.
+ * A move record replaces an unindented G0 or G1 command whose only parameters are X, Y, Z, E and F, each given as a plain number.
+ * It starts with a tag byte that has the top bit set, which no line of text can start with. The tag byte is followed by one value
+ * for each parameter present. Each value is the parameter value multiplied by the scale for that letter, zigzag encoded and stored as a varint
+ * with 6 bits per byte, least significant bits first. Every byte of a varint has the top bit set, and bit 6 set if more bytes follow.
+ * So every byte of a move record has the top bit set and a newline character is always the end of a text line, which lets code that reads
+ * part of a file, such as the file information parser, find the start of a line or record.
+ * Values are absolute rather than relative to the previous record, so that a print can be resumed from the file position of any record.
+ *
+ * The converter is in Tools/gcodecompactor. If you change anything here, change it there too.
+ */
+
+#ifndef SRC_GCODES_COMPACTGCODE_H_
+#define SRC_GCODES_COMPACTGCODE_H_
+
+#include <cstdint>
+#include <cstddef>
+
+namespace CompactGCode
+{
+	constexpr char Signature[] = ";RepRapFirmware compact G-code 2\n";			// first line of every compact G-code file
+	constexpr size_t SignatureLength = sizeof(Signature) - 1;
+
+	constexpr uint8_t MoveRecordFlag = 0x80;				// set in the tag byte of a move record
+	constexpr uint8_t G1Flag = 0x40;						// set in the tag byte if the command is G1, clear if it is G0
+	constexpr uint8_t ParameterFlagsMask = 0x1F;			// bit n of the tag byte is set if ParameterLetters[n] is present
+
+	constexpr unsigned int NumParameters = 5;
+	constexpr const char *ParameterLetters = "XYZEF";
+	constexpr int32_t ParameterScales[NumParameters] = { 1000, 1000, 1000, 100000, 10 };
+	constexpr unsigned int ParameterDecimals[NumParameters] = { 3, 3, 3, 5, 1 };
+
+	constexpr uint8_t VarintByteFlag = 0x80;				// set in every byte of a varint
+	constexpr uint8_t VarintMoreFlag = 0x40;				// set in every byte of a varint except the last
+	constexpr uint8_t VarintPayloadMask = 0x3F;
+	constexpr unsigned int VarintPayloadBits = 6;
+	constexpr size_t MaxVarintLength = 6;					// a 32-bit value never needs more than 6 bytes
+	constexpr size_t MaxMoveRecordLength = 1 + NumParameters * MaxVarintLength;
+
+	// Convert a zigzag-encoded value to the value of parameter ParameterLetters[i].
+	// The integer and fractional parts are scaled separately so that large values such as absolute extrusion keep their precision.
+	inline float DecodeValue(uint32_t raw, unsigned int i) noexcept
+	{
+		const int32_t ival = (int32_t)(raw >> 1) ^ -(int32_t)(raw & 1u);
+		const int32_t scale = ParameterScales[i];
+		return (float)(ival / scale) + (float)(ival % scale)/(float)scale;
+	}
+}
+
+#endif /* SRC_GCODES_COMPACTGCODE_H_ */
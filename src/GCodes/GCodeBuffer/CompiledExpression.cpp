@@ -0,0 +1,691 @@
+/*
+ * CompiledExpression.cpp
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include "CompiledExpression.h"
+
+#if SUPPORT_COMPILED_EXPRESSIONS
+
+#include "GCodeBuffer.h"
+#include "ExpressionParser.h"
+#include <Platform/RepRap.h>
+#include <ObjectModel/Variable.h>
+#include <General/NumericConverter.h>
+
+// Class used to compile a condition. The grammar, operator priorities and checks follow ExpressionParser::ParseInternal, so that a compiled condition
+// gives the same result as ExpressionParser. Each function returns false if the text uses something that we don't compile or that ExpressionParser
+// would report as an error, so that we leave it to ExpressionParser to evaluate the condition or report the error.
+class CompiledExpression::Compiler
+{
+public:
+	Compiler(CompiledExpression& p_ce) noexcept
+		: ce(p_ce), currentp(p_ce.text), endp(p_ce.text + p_ce.textLength), stackDepth(0), nesting(0), inConditionalPart(false) { }
+
+	bool CompileCondition() noexcept;
+
+private:
+	static constexpr unsigned int MaxNesting = 10;
+
+	bool CompileInternal(uint8_t priority) noexcept;
+	bool CompileExpectKet(char closingBracket) noexcept;
+	bool CompileNumber() noexcept;
+	bool CompileQuotedString() noexcept;
+	bool CompileIdentifier() noexcept;
+
+	bool EmitOp(Op op) noexcept { return EmitByte((uint8_t)op); }
+	bool EmitByte(uint8_t b) noexcept;
+	bool EmitBytes(const void *data, size_t length) noexcept;
+	bool EmitPush(Op op) noexcept;
+
+	char CurrentCharacter() const noexcept { return (currentp < endp) ? *currentp : 0; }
+	void AdvancePointer() noexcept { ++currentp; }
+	void SkipWhiteSpace() noexcept;
+
+	CompiledExpression& ce;
+	const char *_ecv_array currentp;
+	const char *_ecv_array const endp;
+	unsigned int stackDepth;
+	unsigned int nesting;
+	bool inConditionalPart;									// true if we are compiling an operand that may not be evaluated
+};
+
+bool CompiledExpression::Compiler::CompileCondition() noexcept
+{
+	if (!CompileInternal(0))
+	{
+		return false;
+	}
+	SkipWhiteSpace();
+	return CurrentCharacter() == 0 && stackDepth == 1;
+}
+
+bool CompiledExpression::Compiler::CompileInternal(uint8_t priority) noexcept
+{
+	static constexpr const char *operators = "?^&|!=<>+-*/";
+	static constexpr uint8_t priorities[] = { 1, 2, 3, 3, 4, 4, 4, 4, 5, 5, 6, 6 };
+	constexpr uint8_t UnaryPriority = 10;
+	static_assert(ARRAY_SIZE(priorities) == strlen(operators));
+
+	if (nesting == MaxNesting)
+	{
+		return false;
+	}
+	++nesting;
+
+	SkipWhiteSpace();
+	const char c = CurrentCharacter();
+	bool ok;
+	switch (c)
+	{
+	case '"':
+		ok = CompileQuotedString();
+		break;
+
+	case '-':
+		// ExpressionParser checks the type of the operand of unary minus even when it isn't evaluating it, so don't compile it in an operand that may be skipped
+		AdvancePointer();
+		ok = !inConditionalPart && CompileInternal(UnaryPriority) && EmitOp(Op::negate);
+		break;
+
+	case '!':
+		AdvancePointer();
+		ok = CompileInternal(UnaryPriority) && EmitOp(Op::invert);
+		break;
+
+	case '{':
+		AdvancePointer();
+		ok = CompileExpectKet('}');
+		break;
+
+	case '(':
+		AdvancePointer();
+		ok = CompileExpectKet(')');
+		break;
+
+	default:
+		ok = (isdigit(c)) ? CompileNumber()
+				: (isalpha(c)) ? CompileIdentifier()
+					: false;
+		break;
+	}
+
+	// See if it is followed by a binary operator
+	while (ok)
+	{
+		SkipWhiteSpace();
+		char opChar = CurrentCharacter();
+		if (opChar == 0)
+		{
+			break;
+		}
+		const char * const q = strchr(operators, opChar);
+		if (q == nullptr)
+		{
+			break;
+		}
+		const uint8_t opPrio = priorities[q - operators];
+		if (opPrio <= priority)
+		{
+			break;
+		}
+		if (opChar == '?' || opChar == '^')
+		{
+			ok = false;
+			break;
+		}
+
+		AdvancePointer();
+		bool invert = false;
+		if (opChar == '!')
+		{
+			if (CurrentCharacter() != '=')
+			{
+				ok = false;
+				break;
+			}
+			invert = true;
+			AdvancePointer();
+			opChar = '=';
+		}
+		else if ((opChar == '>' || opChar == '<') && CurrentCharacter() == '=')
+		{
+			invert = true;
+			AdvancePointer();
+			opChar ^= ('>' ^ '<');
+		}
+
+		if ((opChar == '=' || opChar == '&' || opChar == '|') && CurrentCharacter() == opChar)
+		{
+			AdvancePointer();
+		}
+
+		if (opChar == '&' || opChar == '|')
+		{
+			// Emit a conditional jump over the second operand, which we patch when we know its length
+			if (!EmitOp((opChar == '&') ? Op::andJump : Op::orJump) || !EmitByte(0))
+			{
+				ok = false;
+				break;
+			}
+			const size_t jumpOffsetIndex = ce.codeLength - 1;
+			--stackDepth;										// if we don't jump then the first operand is popped
+			const bool wasInConditionalPart = inConditionalPart;
+			inConditionalPart = true;
+			ok = CompileInternal(opPrio) && EmitOp(Op::checkBool);
+			inConditionalPart = wasInConditionalPart;
+			ce.code[jumpOffsetIndex] = (uint8_t)(ce.codeLength - jumpOffsetIndex - 1);
+		}
+		else
+		{
+			Op op;
+			switch (opChar)
+			{
+			case '+':	op = Op::add; break;
+			case '-':	op = Op::subtract; break;
+			case '*':	op = Op::multiply; break;
+			case '/':	op = Op::divide; break;
+			case '=':	op = (invert) ? Op::notEqual : Op::equal; break;
+			case '<':	op = (invert) ? Op::greaterOrEqual : Op::less; break;		// ExpressionParser evaluates >= as not <
+			default:	op = (invert) ? Op::lessOrEqual : Op::greater; break;		// ExpressionParser evaluates <= as not >
+			}
+			ok = CompileInternal(opPrio) && EmitOp(op);
+			--stackDepth;
+		}
+	}
+
+	--nesting;
+	return ok;
+}
+
+bool CompiledExpression::Compiler::CompileExpectKet(char closingBracket) noexcept
+{
+	if (!CompileInternal(0) || CurrentCharacter() != closingBracket)
+	{
+		return false;
+	}
+	AdvancePointer();
+	return true;
+}
+
+// Compile a number. The initial character is a decimal digit.
+bool CompiledExpression::Compiler::CompileNumber() noexcept
+{
+	NumericConverter conv;
+	conv.Accumulate(CurrentCharacter(), NumericConverter::AcceptSignedFloat | NumericConverter::AcceptHex, [this]()->char { AdvancePointer(); return CurrentCharacter(); });
+
+	if (conv.FitsInInt32())
+	{
+		const int32_t i = conv.GetInt32();
+		return EmitPush(Op::pushInt) && EmitBytes(&i, sizeof(i));
+	}
+
+	const float f = conv.GetFloat();
+	return EmitPush(Op::pushFloat) && EmitBytes(&f, sizeof(f))
+		&& EmitByte((uint8_t)constrain<unsigned int>(conv.GetDigitsAfterPoint(), 1, MaxFloatDigitsDisplayedAfterPoint));
+}
+
+// Compile a quoted string, given that the current character is double-quote. The rules are the same as in ExpressionParser::ParseQuotedString.
+bool CompiledExpression::Compiler::CompileQuotedString() noexcept
+{
+	if (!EmitPush(Op::pushString))
+	{
+		return false;
+	}
+	AdvancePointer();
+	for (;;)
+	{
+		char c = CurrentCharacter();
+		AdvancePointer();
+		if (c < ' ')
+		{
+			return false;
+		}
+		if (c == '"')
+		{
+			if (CurrentCharacter() != c)
+			{
+				return EmitByte(0);
+			}
+			AdvancePointer();
+		}
+		else if (c == '\'')
+		{
+			if (isalpha(CurrentCharacter()))
+			{
+				c = tolower(CurrentCharacter());
+				AdvancePointer();
+			}
+			else if (CurrentCharacter() == c)
+			{
+				AdvancePointer();
+			}
+		}
+		if (!EmitByte((uint8_t)c))
+		{
+			return false;
+		}
+	}
+}
+
+// Compile an identifier. Named constants are compiled to their own opcodes, variables to their names, and anything else to an object model path.
+bool CompiledExpression::Compiler::CompileIdentifier() noexcept
+{
+	const size_t columnOffset = currentp - ce.text;
+	String<MaxVariableNameLength> id;
+	char c;
+	while (isalpha((c = CurrentCharacter())) || isdigit(c) || c == '_' || c == '.' || c == '[')
+	{
+		if (c == '[' || id.cat(c))
+		{
+			return false;										// we don't compile array indices
+		}
+		AdvancePointer();
+	}
+
+	if (strcmp(id.c_str(), "true") == 0 || strcmp(id.c_str(), "false") == 0)
+	{
+		return EmitPush(Op::pushBool) && EmitByte((id.c_str()[0] == 't') ? 1 : 0);
+	}
+	if (strcmp(id.c_str(), "null") == 0)
+	{
+		return EmitPush(Op::pushNull);
+	}
+	if (strcmp(id.c_str(), "pi") == 0)
+	{
+		const float f = Pi;
+		return EmitPush(Op::pushFloat) && EmitBytes(&f, sizeof(f)) && EmitByte(MaxFloatDigitsDisplayedAfterPoint);
+	}
+	if (strcmp(id.c_str(), "iterations") == 0)
+	{
+		ce.usesIterations = true;
+		return EmitPush(Op::pushIterations);
+	}
+	if (strcmp(id.c_str(), "line") == 0)
+	{
+		return EmitPush(Op::pushLine);
+	}
+	if (strcmp(id.c_str(), "result") == 0)
+	{
+		return EmitPush(Op::pushResult);
+	}
+
+	SkipWhiteSpace();
+	if (CurrentCharacter() == '(')
+	{
+		return false;											// we don't compile function calls
+	}
+
+	const char *name = id.c_str();
+	bool ok;
+	if (StringStartsWith(name, "param."))
+	{
+		ok = EmitPush(Op::pushParameter);
+		name += strlen("param.");
+	}
+	else if (StringStartsWith(name, "global."))
+	{
+		ok = EmitPush(Op::pushGlobal);
+		name += strlen("global.");
+	}
+	else if (StringStartsWith(name, "var."))
+	{
+		ok = EmitPush(Op::pushVariable);
+		name += strlen("var.");
+	}
+	else
+	{
+		ok = EmitPush(Op::pushObjectModel) && EmitByte((uint8_t)columnOffset);
+	}
+	return ok && EmitBytes(name, strlen(name) + 1);
+}
+
+bool CompiledExpression::Compiler::EmitByte(uint8_t b) noexcept
+{
+	if (ce.codeLength == MaxCodeLength)
+	{
+		return false;
+	}
+	ce.code[ce.codeLength++] = b;
+	return true;
+}
+
+bool CompiledExpression::Compiler::EmitBytes(const void *data, size_t length) noexcept
+{
+	if (ce.codeLength + length > MaxCodeLength)
+	{
+		return false;
+	}
+	memcpy(ce.code + ce.codeLength, data, length);
+	ce.codeLength += length;
+	return true;
+}
+
+// Emit an opcode that pushes a value, checking that the stack won't overflow when we execute it
+bool CompiledExpression::Compiler::EmitPush(Op op) noexcept
+{
+	if (stackDepth == MaxEvaluationDepth)
+	{
+		return false;
+	}
+	++stackDepth;
+	return EmitOp(op);
+}
+
+void CompiledExpression::Compiler::SkipWhiteSpace() noexcept
+{
+	char c;
+	while ((c = CurrentCharacter()) == ' ' || c == '\t')
+	{
+		AdvancePointer();
+	}
+}
+
+// Compile the condition in the specified text, which is the part of a line of GCode at file position 'pos' that follows the command word
+void CompiledExpression::Compile(FilePosition pos, const char *_ecv_array p_text, size_t length) noexcept
+{
+	filePosition = pos;
+	textLength = length;
+	memcpy(text, p_text, length);
+	codeLength = 0;
+	usesIterations = false;
+	Compiler compiler(*this);
+	compiled = compiler.CompileCondition();
+}
+
+// Evaluate a compiled condition. Return true with the value of the condition in 'result' if successful.
+// Return false if ExpressionParser would report an error, so that the caller can evaluate the condition using ExpressionParser to get the error message.
+// 'column' is the column number of the start of the text, as passed to the ExpressionParser constructor.
+bool CompiledExpression::Evaluate(const GCodeBuffer& gb, int column, bool& result) const THROWS(GCodeException)
+{
+	if (usesIterations && gb.CurrentFileMachineState().GetIterations() < 0)
+	{
+		return false;
+	}
+
+	ExpressionValue stack[MaxEvaluationDepth];
+	size_t sp = 0;
+	const uint8_t *_ecv_array pc = code;
+	const uint8_t *_ecv_array const codeEnd = code + codeLength;
+	while (pc < codeEnd)
+	{
+		const Op op = (Op)*pc++;
+		switch (op)
+		{
+		case Op::pushInt:
+			{
+				int32_t i;
+				memcpy(&i, pc, sizeof(i));
+				pc += sizeof(i);
+				stack[sp++].Set(i);
+			}
+			break;
+
+		case Op::pushFloat:
+			{
+				float f;
+				memcpy(&f, pc, sizeof(f));
+				pc += sizeof(f);
+				stack[sp++].Set(f, *pc++);
+			}
+			break;
+
+		case Op::pushBool:
+			stack[sp++].Set(*pc++ != 0);
+			break;
+
+		case Op::pushNull:
+			stack[sp++].Set(nullptr);
+			break;
+
+		case Op::pushString:
+			stack[sp++].Set((const char *_ecv_array)pc);
+			pc += strlen((const char *_ecv_array)pc) + 1;
+			break;
+
+		case Op::pushIterations:
+			stack[sp++].Set((int32_t)gb.CurrentFileMachineState().GetIterations());
+			break;
+
+		case Op::pushLine:
+			stack[sp++].Set((int32_t)gb.GetLineNumber());
+			break;
+
+		case Op::pushResult:
+			stack[sp++].Set((gb.GetLastResult() == GCodeResult::ok) ? (int32_t)0
+							: (gb.GetLastResult() == GCodeResult::warning || gb.GetLastResult() == GCodeResult::warningNotSupported) ? (int32_t)1
+								: (int32_t)2);
+			break;
+
+		case Op::pushParameter:
+		case Op::pushVariable:
+			{
+				const char *_ecv_array const name = (const char *_ecv_array)pc;
+				pc += strlen(name) + 1;
+				const Variable *const var = gb.GetVariables().Lookup(name);
+				if (var == nullptr || (op == Op::pushParameter && var->GetScope() >= 0))
+				{
+					return false;
+				}
+				stack[sp++] = var->GetValue();
+			}
+			break;
+
+		case Op::pushGlobal:
+			{
+				const char *_ecv_array const name = (const char *_ecv_array)pc;
+				pc += strlen(name) + 1;
+				auto vars = reprap.GetGlobalVariablesForReading();
+				const Variable *const var = vars->Lookup(name);
+				if (var == nullptr)
+				{
+					return false;
+				}
+				stack[sp++] = var->GetValue();
+			}
+			break;
+
+		case Op::pushObjectModel:
+			{
+				const unsigned int columnOffset = *pc++;
+				const char *_ecv_array const path = (const char *_ecv_array)pc;
+				pc += strlen(path) + 1;
+				ObjectExplorationContext context(&gb, false, false, gb.GetLineNumber(), (column < 0) ? column : column + (int)columnOffset);
+				stack[sp++] = reprap.GetObjectValueUsingTableNumber(context, nullptr, path, 0);
+				if (context.ObsoleteFieldQueried())
+				{
+					return false;								// let ExpressionParser evaluate it so that it reports the obsolete field
+				}
+			}
+			break;
+
+		case Op::negate:
+			{
+				ExpressionValue& val = stack[sp - 1];
+				if (val.GetType() == TypeCode::Int32)
+				{
+					val.iVal = -val.iVal;
+				}
+				else if (val.GetType() == TypeCode::Float)
+				{
+					val.fVal = -val.fVal;
+				}
+				else
+				{
+					return false;
+				}
+			}
+			break;
+
+		case Op::invert:
+			if (stack[sp - 1].GetType() != TypeCode::Bool)
+			{
+				return false;
+			}
+			stack[sp - 1].bVal = !stack[sp - 1].bVal;
+			break;
+
+		case Op::andJump:
+		case Op::orJump:
+			{
+				const unsigned int offset = *pc++;
+				if (stack[sp - 1].GetType() != TypeCode::Bool)
+				{
+					return false;
+				}
+				if (stack[sp - 1].bVal == (op == Op::orJump))
+				{
+					pc += offset;								// the result is the first operand, so skip the second one
+				}
+				else
+				{
+					--sp;										// the result is the second operand
+				}
+			}
+			break;
+
+		case Op::checkBool:
+			if (stack[sp - 1].GetType() != TypeCode::Bool)
+			{
+				return false;
+			}
+			break;
+
+		default:
+			{
+				// Binary operators
+				ExpressionValue& val = stack[sp - 2];
+				ExpressionValue& val2 = stack[sp - 1];
+				switch (op)
+				{
+				case Op::add:
+				case Op::subtract:
+				case Op::multiply:
+					if (!ExpressionParser::BalanceNumericTypes(val, val2))		// this also rejects DateTime operands, which ExpressionParser handles specially
+					{
+						return false;
+					}
+					if (val.GetType() == TypeCode::Float)
+					{
+						val.fVal = (op == Op::add) ? val.fVal + val2.fVal : (op == Op::subtract) ? val.fVal - val2.fVal : val.fVal * val2.fVal;
+						val.param = max(val.param, val2.param);
+					}
+					else
+					{
+						val.iVal = (op == Op::add) ? val.iVal + val2.iVal : (op == Op::subtract) ? val.iVal - val2.iVal : val.iVal * val2.iVal;
+					}
+					break;
+
+				case Op::divide:
+					if (!ExpressionParser::BalanceNumericTypes(val, val2))
+					{
+						return false;
+					}
+					if (val.GetType() == TypeCode::Int32)
+					{
+						val.Set((float)val.iVal, 1);
+						val2.Set((float)val2.iVal, 1);
+					}
+					val.fVal /= val2.fVal;
+					val.param = MaxFloatDigitsDisplayedAfterPoint;
+					break;
+
+				case Op::equal:
+				case Op::notEqual:
+					{
+						bool b;
+						if (val.GetType() == TypeCode::None)
+						{
+							b = (val2.GetType() == TypeCode::None);
+						}
+						else if (val2.GetType() == TypeCode::None)
+						{
+							b = false;
+						}
+						else
+						{
+							if (!ExpressionParser::BalanceComparisonTypes(val, val2))
+							{
+								return false;
+							}
+							switch (val.GetType())
+							{
+							case TypeCode::Int32:
+								b = (val.iVal == val2.iVal);
+								break;
+
+							case TypeCode::Float:
+								b = (val.fVal == val2.fVal);
+								break;
+
+							case TypeCode::Bool:
+								b = (val.bVal == val2.bVal);
+								break;
+
+							case TypeCode::CString:
+							case TypeCode::HeapString:
+								b = (strcmp((val.GetType() == TypeCode::HeapString) ? val.shVal.Get().Ptr() : val.sVal,
+											(val2.GetType() == TypeCode::HeapString) ? val2.shVal.Get().Ptr() : val2.sVal) == 0);
+								break;
+
+							default:
+								return false;
+							}
+						}
+						val.Set(b != (op == Op::notEqual));
+					}
+					break;
+
+				case Op::less:
+				case Op::greaterOrEqual:
+				case Op::greater:
+				case Op::lessOrEqual:
+					{
+						if (!ExpressionParser::BalanceComparisonTypes(val, val2))
+						{
+							return false;
+						}
+						const bool wantLess = (op == Op::less || op == Op::greaterOrEqual);
+						bool b;
+						switch (val.GetType())
+						{
+						case TypeCode::Int32:
+							b = (wantLess) ? val.iVal < val2.iVal : val.iVal > val2.iVal;
+							break;
+
+						case TypeCode::Float:
+							b = (wantLess) ? val.fVal < val2.fVal : val.fVal > val2.fVal;
+							break;
+
+						case TypeCode::Bool:
+							b = (wantLess) ? (!val.bVal && val2.bVal) : (val.bVal && !val2.bVal);
+							break;
+
+						default:
+							return false;
+						}
+						val.Set(b != (op == Op::greaterOrEqual || op == Op::lessOrEqual));
+					}
+					break;
+
+				default:
+					return false;
+				}
+				stack[--sp].Release();
+			}
+			break;
+		}
+	}
+
+	if (sp != 1 || stack[0].GetType() != TypeCode::Bool)
+	{
+		return false;
+	}
+	result = stack[0].bVal;
+	return true;
+}
+
+#endif
+
+// End
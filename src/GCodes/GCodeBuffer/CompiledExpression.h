@@ -0,0 +1,70 @@
+/*
+ * CompiledExpression.h
+ *
+ *  Created on: 17 Oct 2026
+ *
+ * A CompiledExpression holds the condition of an 'if', 'elif' or 'while' command compiled to a program for a small stack machine,
+ * so that when a macro loops we don't need to tokenise the same text on every iteration. Literals are converted to binary when compiling,
+ * and identifiers are reduced to the variable name or object model path that we need to look up. Object model paths are still looked up by name
+ * each time the condition is evaluated, because the objects they refer to (for example tools, heaters and filament monitors) can be created
+ * and deleted while a macro is running, so a pointer resolved when compiling could be left dangling.
+ *
+ * Only the common subset of the expression language is compiled: numeric, Boolean and string literals, named constants, variables,
+ * object model values without array indices, unary - and !, parentheses and the arithmetic, comparison, & and | operators.
+ * Conditions that use anything else are marked as not compiled and are always evaluated by ExpressionParser.
+ * When evaluating a compiled condition gives a result that ExpressionParser would report as an error, Evaluate returns false and
+ * the caller evaluates the condition again using ExpressionParser, so that error messages are identical.
+ */
+
+#ifndef SRC_GCODES_GCODEBUFFER_COMPILEDEXPRESSION_H_
+#define SRC_GCODES_GCODEBUFFER_COMPILEDEXPRESSION_H_
+
+#include <RepRapFirmware.h>
+
+#if SUPPORT_COMPILED_EXPRESSIONS
+
+#include <ObjectModel/ObjectModel.h>
+#include <GCodes/GCodeException.h>
+
+class CompiledExpression
+{
+public:
+	static constexpr size_t MaxTextLength = 100;				// conditions longer than this are not cached
+	static constexpr size_t MaxCodeLength = 160;
+	static constexpr size_t MaxEvaluationDepth = 8;
+
+	CompiledExpression() noexcept : filePosition(noFilePosition), textLength(0), codeLength(0), compiled(false), usesIterations(false) { }
+
+	bool Matches(FilePosition pos, const char *_ecv_array text, size_t length) const noexcept
+	{
+		return pos == filePosition && length == textLength && memcmp(text, this->text, length) == 0;
+	}
+
+	void Compile(FilePosition pos, const char *_ecv_array p_text, size_t length) noexcept pre(length <= MaxTextLength);
+	bool IsCompiled() const noexcept { return compiled; }
+	bool Evaluate(const GCodeBuffer& gb, int column, bool& result) const THROWS(GCodeException) pre(IsCompiled());
+
+private:
+	enum class Op : uint8_t
+	{
+		pushInt, pushFloat, pushBool, pushNull, pushString, pushIterations, pushLine, pushResult,
+		pushParameter, pushVariable, pushGlobal, pushObjectModel,
+		negate, invert, add, subtract, multiply, divide,
+		equal, notEqual, less, lessOrEqual, greater, greaterOrEqual,
+		andJump, orJump, checkBool
+	};
+
+	class Compiler;
+
+	FilePosition filePosition;									// file position of the line that the condition came from
+	uint8_t textLength;
+	uint8_t codeLength;
+	bool compiled;												// false if the condition uses features that we don't compile
+	bool usesIterations;										// true if the condition refers to 'iterations'
+	char text[MaxTextLength];									// the text of the condition, used to check that the line hasn't changed
+	uint8_t code[MaxCodeLength];
+};
+
+#endif
+
+#endif /* SRC_GCODES_GCODEBUFFER_COMPILEDEXPRESSION_H_ */
@@ -649,33 +649,48 @@ void ExpressionParser::ParseDriverIdArray(DriverId arr[], size_t& length) THROWS
 
 void ExpressionParser::BalanceNumericTypes(ExpressionValue& val1, ExpressionValue& val2, bool evaluate) const THROWS(GCodeException)
 {
-	// First convert any Uint64 or Uint32 operands to float
-	if (val1.GetType() == TypeCode::Uint64 || val1.GetType() == TypeCode::Uint32)
+	if (!BalanceNumericTypes(val1, val2))
 	{
-		ConvertToFloat(val1, evaluate);
-	}
-	if (val2.GetType() == TypeCode::Uint64 || val2.GetType() == TypeCode::Uint32)
-	{
-		ConvertToFloat(val2, evaluate);
+		if (val1.GetType() == TypeCode::Float || val2.GetType() == TypeCode::Float)
+		{
+			// One operand is float and the other is not numeric
+			ConvertToFloat(val1, evaluate);
+			ConvertToFloat(val2, evaluate);
+		}
+		else
+		{
+			if (evaluate)
+			{
+				ThrowParseException("expected numeric operands");
+			}
+			val1.Set((int32_t)0);
+			val2.Set((int32_t)0);
+		}
 	}
+}
 
+// Convert any Uint64 or Uint32 operands to float and then make both operands float if either of them is. Return false if the operands are not both numeric.
+/*static*/ bool ExpressionParser::BalanceNumericTypes(ExpressionValue& val1, ExpressionValue& val2) noexcept
+{
+	ConvertUnsignedToFloat(val1);
+	ConvertUnsignedToFloat(val2);
 	if (val1.GetType() == TypeCode::Float)
 	{
-		ConvertToFloat(val2, evaluate);						// both are now float
-	}
-	else if (val2.GetType() == TypeCode::Float)
-	{
-		ConvertToFloat(val1, evaluate);						// both are now float
+		if (val2.GetType() == TypeCode::Int32)
+		{
+			val2.Set((float)val2.iVal, 1);
+		}
+		return val2.GetType() == TypeCode::Float;
 	}
-	else if (val1.GetType() != TypeCode::Int32 || val2.GetType() != TypeCode::Int32)
+	if (val2.GetType() == TypeCode::Float)
 	{
-		if (evaluate)
+		if (val1.GetType() == TypeCode::Int32)
 		{
-			ThrowParseException("expected numeric operands");
+			val1.Set((float)val1.iVal, 1);
 		}
-		val1.Set((int32_t)0);
-		val2.Set((int32_t)0);
+		return val1.GetType() == TypeCode::Float;
 	}
+	return val1.GetType() == TypeCode::Int32 && val2.GetType() == TypeCode::Int32;
 }
 
 // Return true if the specified type has no literals and should therefore be converted to string when comparing with another value that is not of the same type.
@@ -688,16 +703,6 @@ void ExpressionParser::BalanceNumericTypes(ExpressionValue& val1, ExpressionValu
 // Balance types for a comparison operator
 void ExpressionParser::BalanceTypes(ExpressionValue& val1, ExpressionValue& val2, bool evaluate) THROWS(GCodeException)
 {
-	// First convert any Uint64 or Uint32 operands to float
-	if (val1.GetType() == TypeCode::Uint64 || val1.GetType() == TypeCode::Uint32)
-	{
-		ConvertToFloat(val1, evaluate);
-	}
-	if (val2.GetType() == TypeCode::Uint64 || val2.GetType() == TypeCode::Uint32)
-	{
-		ConvertToFloat(val2, evaluate);
-	}
-
 	// Convert any port or unique ID values to string
 	if (val1.GetType() == TypeCode::Port || val1.GetType() == TypeCode::UniqueId_tc)
 	{
@@ -708,9 +713,9 @@ void ExpressionParser::BalanceTypes(ExpressionValue& val1, ExpressionValue& val2
 		ConvertToString(val2, evaluate);
 	}
 
-	if ((val1.GetType() == val2.GetType()) || (val1.IsStringType() && val2.IsStringType()))			// handle the common case first
+	if (BalanceComparisonTypes(val1, val2))			// handle the common cases first
 	{
-		// nothing to do
+		// nothing more to do
 	}
 	else if (val1.GetType() == TypeCode::Float)
 	{
@@ -739,6 +744,54 @@ void ExpressionParser::BalanceTypes(ExpressionValue& val1, ExpressionValue& val2
 	}
 }
 
+// Balance types for a comparison operator in the common cases that don't need conversion to string.
+// Convert any Uint64 or Uint32 operands to float, then return true if the operands have the same type or are both strings, converting Int32 to float if the other operand is float.
+// Port and UniqueId values are not handled here because they must be converted to string first, so return false for them.
+/*static*/ bool ExpressionParser::BalanceComparisonTypes(ExpressionValue& val1, ExpressionValue& val2) noexcept
+{
+	ConvertUnsignedToFloat(val1);
+	ConvertUnsignedToFloat(val2);
+	if (   val1.GetType() == TypeCode::Port || val1.GetType() == TypeCode::UniqueId_tc
+		|| val2.GetType() == TypeCode::Port || val2.GetType() == TypeCode::UniqueId_tc
+	   )
+	{
+		return false;
+	}
+	if (val1.GetType() == val2.GetType() || (val1.IsStringType() && val2.IsStringType()))
+	{
+		return true;
+	}
+	if (val1.GetType() == TypeCode::Float && val2.GetType() == TypeCode::Int32)
+	{
+		val2.Set((float)val2.iVal, 1);
+		return true;
+	}
+	if (val2.GetType() == TypeCode::Float && val1.GetType() == TypeCode::Int32)
+	{
+		val1.Set((float)val1.iVal, 1);
+		return true;
+	}
+	return false;
+}
+
+// Convert a Uint32 or Uint64 value to float, leaving other types unchanged
+/*static*/ void ExpressionParser::ConvertUnsignedToFloat(ExpressionValue& val) noexcept
+{
+	switch (val.GetType())
+	{
+	case TypeCode::Uint32:
+		val.Set((float)val.uVal, 1);
+		break;
+
+	case TypeCode::Uint64:
+		val.Set((float)val.Get56BitValue(), 1);
+		break;
+
+	default:
+		break;
+	}
+}
+
 void ExpressionParser::ConvertToFloat(ExpressionValue& val, bool evaluate) const THROWS(GCodeException)
 {
 	switch (val.GetType())
@@ -36,6 +36,10 @@ public:
 	void CheckForExtraCharacters() THROWS(GCodeException);
 	const char *GetEndptr() const noexcept { return currentp; }
 
+	// These are also used by CompiledExpression. They return false in the cases that the corresponding non-static functions report as errors or leave to the caller.
+	static bool BalanceNumericTypes(ExpressionValue& val1, ExpressionValue& val2) noexcept;
+	static bool BalanceComparisonTypes(ExpressionValue& val1, ExpressionValue& val2) noexcept;
+
 private:
 	[[noreturn]] void __attribute__((noinline)) ThrowParseException(const char *str) const THROWS(GCodeException);
 	[[noreturn]] void __attribute__((noinline)) ThrowParseException(const char *str, const char *param) const THROWS(GCodeException);
@@ -67,6 +71,7 @@ private:
 	void BalanceNumericTypes(ExpressionValue& val1, ExpressionValue& val2, bool evaluate) const THROWS(GCodeException);
 	void BalanceTypes(ExpressionValue& val1, ExpressionValue& val2, bool evaluate) THROWS(GCodeException);
 	static bool TypeHasNoLiterals(TypeCode t) noexcept;
+	static void ConvertUnsignedToFloat(ExpressionValue& val) noexcept;
 
 	int GetColumn() const noexcept;
 	char CurrentCharacter() const noexcept;
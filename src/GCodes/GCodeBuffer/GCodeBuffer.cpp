@@ -268,6 +268,20 @@ void GCodeBuffer::PutBinary(const uint32_t *data, size_t len) noexcept
 
 #endif
 
+#if SUPPORT_COMPACT_GCODE
+
+// Add a G0 or G1 command that has been read from a compact G-code file and is already parsed
+void GCodeBuffer::PutCompactMove(int gCode, Bitmap<uint32_t> params, const float values[], size_t recordLength) noexcept
+{
+#if HAS_SBC_INTERFACE
+	machineState->lastCodeFromSbc = false;
+	isBinaryBuffer = false;
+#endif
+	stringParser.PutCompactMove(gCode, params, values, recordLength);
+}
+
+#endif
+
 // Add an entire G-Code, overwriting any existing content
 void GCodeBuffer::PutAndDecode(const char *str, size_t len) noexcept
 {
@@ -845,6 +859,12 @@ bool GCodeBuffer::PopState() noexcept
 
 	machineState = ms->Pop();						// get the previous state and copy down any error message
 	delete ms;
+#if SUPPORT_COMPILED_EXPRESSIONS
+	if (!machineState->DoingFile())
+	{
+		stringParser.ReleaseCompiledConditions();	// we have finished the last macro or file, so we don't need the cached conditions any more
+	}
+#endif
 
 	reprap.InputsUpdated();
 	return true;
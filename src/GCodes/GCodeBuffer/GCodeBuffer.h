@@ -52,6 +52,10 @@ public:
 	bool Put(char c) noexcept SPEED_CRITICAL;									// Add a character to the end
 #if HAS_SBC_INTERFACE
 	void PutBinary(const uint32_t *data, size_t len) noexcept;					// Add an entire binary G-Code, overwriting any existing content
+#endif
+#if SUPPORT_COMPACT_GCODE
+	void PutCompactMove(int gCode, Bitmap<uint32_t> params, const float values[], size_t recordLength) noexcept;	// Add a G0 or G1 command read from a compact G-code file
+	bool IsAtStartOfLine() const noexcept { return stringParser.IsAtStartOfLine(); }	// Return true if no characters of the next line have been received
 #endif
 	void PutAndDecode(const char *data, size_t len) noexcept;					// Add an entire G-Code, overwriting any existing content
 	void PutAndDecode(const char *str) noexcept;								// Add a null-terminated string, overwriting any existing content
@@ -10,6 +10,7 @@
 #include "StringParser.h"
 #include "GCodeBuffer.h"
 #include "ExpressionParser.h"
+#include "CompiledExpression.h"
 
 #include <GCodes/GCodes.h>
 #include <Platform/Platform.h>
@@ -25,7 +26,11 @@ static constexpr char eofString[] = EOF_STRING;		// What's at the end of an HTML
 #endif
 
 StringParser::StringParser(GCodeBuffer& gcodeBuffer) noexcept
-	: gb(gcodeBuffer), fileBeingWritten(nullptr), writingFileSize(0), indentToSkipTo(NoIndentSkip), eofStringCounter(0),
+	: gb(gcodeBuffer),
+#if SUPPORT_COMPILED_EXPRESSIONS
+	  compiledConditions(nullptr), nextCompiledCondition(0),
+#endif
+	  fileBeingWritten(nullptr), writingFileSize(0), indentToSkipTo(NoIndentSkip), eofStringCounter(0),
 	  hasCommandNumber(false), commandLetter('Q'), checksumRequired(false), crcRequired(false), binaryWriting(false)
 {
 	StartNewFile();
@@ -37,7 +42,10 @@ void StringParser::Init() noexcept
 	gcodeLineEnd = 0;
 	commandStart = commandLength = 0;								// set both to zero so that calls to GetFilePosition don't return negative values
 	readPointer = -1;
-	hadLineNumber = hadChecksum = overflowed = seenExpression = false;
+	hadLineNumber = hadChecksum = overflowed = seenExpression = parameterOffsetsValid = false;
+#if SUPPORT_COMPACT_GCODE
+	compactCommand = false;
+#endif
 	computedChecksum = 0;
 	gb.bufferState = GCodeBufferState::parseNotStarted;
 	commandIndent = 0;
@@ -862,18 +870,87 @@ void StringParser::ProcessEchoCommand(const StringRef& reply) THROWS(GCodeExcept
 // Evaluate the condition that should follow 'if' or 'while'
 bool StringParser::EvaluateCondition() THROWS(GCodeException)
 {
+#if SUPPORT_COMPILED_EXPRESSIONS
+	// If we have already compiled this condition then use the compiled version, unless evaluating it would give an error
+	CompiledExpression * const ce = GetCompiledCondition(gb.buffer + readPointer);
+	bool result;
+	if (ce != nullptr && ce->IsCompiled() && ce->Evaluate(gb, commandIndent + readPointer, result))
+	{
+		return result;
+	}
+#endif
+
 	ExpressionParser parser(gb, gb.buffer + readPointer, gb.buffer + ARRAY_SIZE(gb.buffer), commandIndent + readPointer);
 	const bool b = parser.ParseBoolean();
 	parser.CheckForExtraCharacters();
 	return b;
 }
 
+#if SUPPORT_COMPILED_EXPRESSIONS
+
+// Find the compiled version of the condition that starts at 'text' in the current line of the file we are executing, compiling it if we don't have it already.
+// Return nullptr if we can't cache it.
+CompiledExpression *_ecv_null StringParser::GetCompiledCondition(const char *_ecv_array text) noexcept
+{
+	const FilePosition pos = GetFilePosition();
+	const size_t length = strnlen(text, ARRAY_SIZE(gb.buffer) - (text - gb.buffer));
+	if (pos == noFilePosition || length > CompiledExpression::MaxTextLength)
+	{
+		return nullptr;
+	}
+
+	if (compiledConditions == nullptr)
+	{
+		compiledConditions = new CompiledExpression[NumCompiledConditions];
+	}
+	else
+	{
+		for (size_t i = 0; i < NumCompiledConditions; ++i)
+		{
+			if (compiledConditions[i].Matches(pos, text, length))
+			{
+				return &compiledConditions[i];
+			}
+		}
+	}
+
+	CompiledExpression& ce = compiledConditions[nextCompiledCondition];
+	nextCompiledCondition = (nextCompiledCondition + 1) % NumCompiledConditions;
+	ce.Compile(pos, text, length);
+	return &ce;
+}
+
+// Free the cache of compiled conditions. This is called when this channel has finished executing files, so that the memory is only in use while macros are running.
+void StringParser::ReleaseCompiledConditions() noexcept
+{
+	delete[] compiledConditions;
+	compiledConditions = nullptr;
+	nextCompiledCondition = 0;
+}
+
+#endif
+
 // Decode this command and find the start of the next one on the same line.
 // On entry, 'commandStart' has already been set to the address the start of where the command should be
 // and 'commandIndent' is the number of leading whitespace characters at the start of the current line.
 // On return, the state must be set to 'ready' to indicate that a command is available and we should stop adding characters.
 void StringParser::DecodeCommand() noexcept
 {
+#if SUPPORT_COMPACT_GCODE
+	if (compactCommand)
+	{
+		// The command was decoded when the move record was read, so we just need to report it if debugging is enabled
+		if (reprap.GetDebugFlags(moduleGcodes).IsBitSet(gb.GetChannel().ToBaseType()))
+		{
+			String<StringLength100> buf;
+			AppendFullCommand(buf.GetRef());
+			debugPrintf("%s: %s\n", gb.GetChannel().ToString(), buf.c_str());
+		}
+		gb.bufferState = GCodeBufferState::ready;
+		return;
+	}
+#endif
+
 	// Check for a valid command letter at the start
 	char cl = gb.buffer[commandStart];
 	if (cl == '\'')									// check for a lowercase axis letter in Fanuc mode
@@ -950,6 +1027,7 @@ void StringParser::DecodeCommand() noexcept
 		hasCommandNumber = true;
 		parameterStart = 1;															// there is a single unquoted string parameter, which is the remainder of the line
 		commandEnd = gcodeLineEnd;
+		parameterOffsetsValid = false;
 	}
 	else if (   hasCommandNumber
 			 && commandLetter == 'G'
@@ -974,6 +1052,7 @@ void StringParser::DecodeCommand() noexcept
 		commandFraction = -1;
 		parameterStart = commandStart;
 		commandEnd = gcodeLineEnd;
+		parameterOffsetsValid = false;
 	}
 
 	gb.bufferState = GCodeBufferState::ready;
@@ -981,11 +1060,16 @@ void StringParser::DecodeCommand() noexcept
 
 // Find where the end of the command is. We assume that a G or M not inside quotes or { } and not preceded by ' is the start of a new command.
 // This isn't true if the command has an unquoted string argument, but we deal with that later.
+// While doing this we record where each parameter letter first occurs, so that Seen() doesn't need to search the command again.
+// The rules for recognising a parameter letter must be kept the same as in ScanForParameter.
 void StringParser::FindParameters() noexcept
 {
 	bool inQuotes = false;
+	bool escaped = false;
 	unsigned int localBraceCount = 0;
 	parametersPresent.Clear();
+	memset(parameterOffsets, 0, sizeof(parameterOffsets));
+	memset(lowerCaseParameterOffsets, 0, sizeof(lowerCaseParameterOffsets));
 	for (commandEnd = parameterStart; commandEnd < gcodeLineEnd; ++commandEnd)
 	{
 		const char c = gb.buffer[commandEnd];
@@ -998,6 +1082,7 @@ void StringParser::FindParameters() noexcept
 			if (c == '{')
 			{
 				++localBraceCount;
+				escaped = false;
 			}
 			else if (localBraceCount != 0)
 			{
@@ -1005,6 +1090,11 @@ void StringParser::FindParameters() noexcept
 				{
 					--localBraceCount;
 				}
+				escaped = (c == '\'' && !escaped);
+			}
+			else if (c == '\'' && !escaped)
+			{
+				escaped = true;
 			}
 			else
 			{
@@ -1016,12 +1106,51 @@ void StringParser::FindParameters() noexcept
 				if (c2 >= 'A' && c2 <= 'Z' && (c2 != 'E' || commandEnd == parameterStart || !isdigit(gb.buffer[commandEnd - 1])))
 				{
 					parametersPresent.SetBit(c2 - 'A');
+					uint16_t& offset = (escaped) ? lowerCaseParameterOffsets[c2 - 'A'] : parameterOffsets[c2 - 'A'];
+					if (offset == 0)
+					{
+						offset = commandEnd + 1;
+					}
 				}
+				escaped = false;
 			}
 		}
 	}
+	parameterOffsetsValid = true;
+}
+
+#if SUPPORT_COMPACT_GCODE
+
+// Return true if we have not received any characters of the next line yet. This is when a compact G-code move record may be accepted.
+bool StringParser::IsAtStartOfLine() const noexcept
+{
+	return gb.bufferState == GCodeBufferState::parseNotStarted && commandLength == 0;
 }
 
+// Store a G0 or G1 command read from a compact G-code move record. The parameter values have already been converted to floats.
+// 'params' has a bit set for each parameter letter present, and 'values' has one entry for each letter in CompactGCode::ParameterLetters.
+void StringParser::PutCompactMove(int gCode, Bitmap<uint32_t> params, const float values[], size_t recordLength) noexcept
+{
+	++gb.CurrentFileMachineState().lineNumber;					// each move record replaces one line of the original file
+	commandLetter = 'G';
+	hasCommandNumber = true;
+	commandNumber = gCode;
+	commandFraction = -1;
+	parametersPresent = params;
+	memcpy(compactValues, values, sizeof(compactValues));
+	compactCommand = true;
+	parameterOffsetsValid = false;
+
+	// Make the command look like an empty line to everything that looks in the buffer, and set up commandStart and commandLength so that GetFilePosition works
+	gb.buffer[0] = gb.buffer[1] = 0;
+	gcodeLineEnd = commandStart = parameterStart = commandEnd = 0;
+	commandLength = recordLength;
+	readPointer = -1;
+	gb.bufferState = GCodeBufferState::parsingGCode;
+}
+
+#endif
+
 // Add an entire string, overwriting any existing content and adding '\n' at the end if necessary to make it a complete line
 void StringParser::PutAndDecode(const char *str, size_t len) noexcept
 {
@@ -1080,7 +1209,7 @@ FilePosition StringParser::GetFilePosition() const noexcept
 # endif
 	   )
 	{
-		return gb.LatestMachineState().fileState.GetPosition() - gb.fileInput->BytesCached() - commandLength + commandStart;
+		return gb.fileInput->GetPosition(gb.LatestMachineState().fileState) - commandLength + commandStart;
 	}
 #endif
 	return noFilePosition;
@@ -1106,7 +1235,7 @@ bool StringParser::IsLastCommand() const noexcept
 // Leave the pointer one after it for a subsequent read.
 bool StringParser::Seen(char c) noexcept
 {
-	bool wantLowerCase = (c >= 'a');
+	const bool wantLowerCase = (c >= 'a');
 	if (wantLowerCase)
 	{
 		c = toupper(c);
@@ -1116,6 +1245,35 @@ bool StringParser::Seen(char c) noexcept
 		return false;
 	}
 
+#if SUPPORT_COMPACT_GCODE
+	if (compactCommand)
+	{
+		// Compact commands only have upper case parameters
+		if (!wantLowerCase)
+		{
+			compactValueIndex = strchr(CompactGCode::ParameterLetters, c) - CompactGCode::ParameterLetters;
+			readPointer = 1;											// any positive value will do
+			return true;
+		}
+		readPointer = -1;
+		return false;
+	}
+#endif
+
+	if (!parameterOffsetsValid || c < 'A' || c > 'Z')
+	{
+		return ScanForParameter(c, wantLowerCase);
+	}
+
+	const uint16_t offset = (wantLowerCase) ? lowerCaseParameterOffsets[c - 'A'] : parameterOffsets[c - 'A'];
+	readPointer = (offset == 0) ? -1 : (int)offset;
+	return offset != 0;
+}
+
+// Search the command for parameter letter 'c', which has already been converted to upper case.
+// This is used by Seen() when the parameter offsets recorded by FindParameters don't cover the command.
+bool StringParser::ScanForParameter(char c, bool wantLowerCase) noexcept
+{
 	bool inQuotes = false;
 	bool escaped = false;
 	unsigned int inBrackets = 0;
@@ -1173,6 +1331,14 @@ float StringParser::GetFValue() THROWS(GCodeException)
 		THROW_INTERNAL_ERROR;
 	}
 
+#if SUPPORT_COMPACT_GCODE
+	if (compactCommand)
+	{
+		readPointer = -1;
+		return compactValues[compactValueIndex];
+	}
+#endif
+
 	const float result = ReadFloatValue();
 	readPointer = -1;
 	return result;
@@ -1187,6 +1353,15 @@ void StringParser::GetFloatArray(float arr[], size_t& returnedLength) THROWS(GCo
 		THROW_INTERNAL_ERROR;
 	}
 
+#if SUPPORT_COMPACT_GCODE
+	if (compactCommand)
+	{
+		CheckArrayLength(0, returnedLength);
+		arr[0] = compactValues[compactValueIndex];
+		returnedLength = 1;
+	}
+	else
+#endif
 	if (gb.buffer[readPointer] == '{')
 	{
 		ExpressionParser parser(gb, gb.buffer + readPointer, gb.buffer + ARRAY_SIZE(gb.buffer), commandIndent + readPointer);
@@ -1429,6 +1604,7 @@ void StringParser::InternalGetPossiblyQuotedString(const StringRef& str) THROWS(
 	else
 	{
 		commandEnd = gcodeLineEnd;				// the string is the remainder of the line of gcode
+		parameterOffsetsValid = false;			// the parameter offsets don't cover the extended command
 		for (;;)
 		{
 			const char c = gb.buffer[readPointer++];
@@ -1469,6 +1645,14 @@ int32_t StringParser::GetIValue() THROWS(GCodeException)
 		THROW_INTERNAL_ERROR;
 	}
 
+#if SUPPORT_COMPACT_GCODE
+	if (compactCommand)
+	{
+		readPointer = -1;
+		return lrintf(compactValues[compactValueIndex]);
+	}
+#endif
+
 	const int32_t result = ReadIValue();
 	readPointer = -1;
 	return result;
@@ -1596,6 +1780,22 @@ void StringParser::PrintCommand(const StringRef& s) const noexcept
 // This is called when we report a "Bad command" error, so make sure we display any control characters.
 void StringParser::AppendFullCommand(const StringRef &s) const noexcept
 {
+#if SUPPORT_COMPACT_GCODE
+	if (compactCommand)
+	{
+		s.catf("G%d", commandNumber);
+		for (unsigned int i = 0; i < CompactGCode::NumParameters; ++i)
+		{
+			const char letter = CompactGCode::ParameterLetters[i];
+			if (parametersPresent.IsBitSet(letter - 'A'))
+			{
+				s.catf(" %c%.*f", letter, (int)CompactGCode::ParameterDecimals[i], (double)compactValues[i]);
+			}
+		}
+		return;
+	}
+#endif
+
 	for (size_t i = commandStart; i < commandEnd; ++i)
 	{
 		const char c = gb.buffer[i];
@@ -1786,6 +1986,92 @@ void StringParser::CheckNumberFound(const char *endptr) THROWS(GCodeException)
 	readPointer = endptr - gb.buffer;
 }
 
+// Fast path for reading a float parameter. Slicers almost always generate plain fixed-point numbers such as -123.456 or .0312, so we handle those here.
+// If the significand is less than 2^24 and there are no more than 10 decimal places then both the significand and the power of 10 are exactly representable
+// as floats, so a single division gives the correctly rounded result. SafeStrtof is not guaranteed to round correctly, so we must not return a different
+// value from it when the exact value lies very close to halfway between two floats. The remainder of a correctly rounded division is exactly representable,
+// so we compute it using a fused multiply-add and return the quotient only if the exact value is well away from the rounding boundary. Then any conversion
+// that is accurate to within 1/64 of a unit in the last place returns the same float.
+// Return false for anything else (exponents, hex, very long numbers, a trailing decimal point, values near a rounding boundary) so that the caller uses SafeStrtof instead.
+static bool ReadFixedPointFloat(const char *s, const char **endptr, float& result) noexcept SPEED_CRITICAL;
+
+static bool ReadFixedPointFloat(const char *s, const char **endptr, float& result) noexcept
+{
+	static constexpr float PowersOfTen[] = { 1.0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9, 1.0e10 };
+	constexpr unsigned int MaxDecimalPlaces = ARRAY_SIZE(PowersOfTen) - 1;
+	constexpr uint32_t MaxExactSignificand = 1u << 24;
+	constexpr float MaxRemainderUlps = 0.5 - 1.0/64;					// how close to halfway between two floats we allow the exact value to be
+
+	const bool negative = (*s == '-');
+	if (negative || *s == '+')
+	{
+		++s;
+	}
+
+	uint32_t significand = 0;
+	const char * const digitsStart = s;
+	while (isdigit(*s))
+	{
+		significand = (significand * 10) + (*s++ - '0');
+		if (significand >= MaxExactSignificand)
+		{
+			return false;
+		}
+	}
+
+	unsigned int decimalPlaces = 0;
+	if (*s == '.')
+	{
+		++s;
+		if (!isdigit(*s))
+		{
+			return false;
+		}
+		do
+		{
+			significand = (significand * 10) + (*s++ - '0');
+			++decimalPlaces;
+			if (significand >= MaxExactSignificand || decimalPlaces > MaxDecimalPlaces)
+			{
+				return false;
+			}
+		} while (isdigit(*s));
+	}
+	else if (s == digitsStart)
+	{
+		return false;												// no digits
+	}
+
+	if (*s == 'e' || *s == 'E' || *s == 'x' || *s == 'X')
+	{
+		return false;												// SafeStrtof might treat this as an exponent or a hex number
+	}
+
+	const float divisor = PowersOfTen[decimalPlaces];
+	const float f = (float)significand / divisor;
+	if (decimalPlaces != 0 && significand != 0)
+	{
+		// f is normalised because the smallest nonzero value we accept is 1.0e-10, so its unit in the last place is 2^(exponent - 23)
+		const float remainder = fmaf(-f, divisor, (float)significand);	// exact
+		uint32_t bits;
+		memcpy(&bits, &f, sizeof(bits));
+		const uint32_t ulpBits = (bits & 0x7F800000) - (23u << 23);
+		float ulp;
+		memcpy(&ulp, &ulpBits, sizeof(ulp));
+		if (remainder < 0.0 && (bits & 0x007FFFFF) == 0)
+		{
+			ulp *= 0.5;												// f is a power of 2 and the exact value is below it, where the floats are twice as close together
+		}
+		if (fabsf(remainder) > divisor * ulp * MaxRemainderUlps)
+		{
+			return false;
+		}
+	}
+	result = (negative) ? -f : f;
+	*endptr = s;
+	return true;
+}
+
 // Functions to read values from lines of GCode, allowing for expressions and variable substitution
 float StringParser::ReadFloatValue() THROWS(GCodeException)
 {
@@ -1798,7 +2084,11 @@ float StringParser::ReadFloatValue() THROWS(GCodeException)
 	}
 
 	const char *endptr;
-	const float rslt = SafeStrtof(gb.buffer + readPointer, &endptr);
+	float rslt;
+	if (!ReadFixedPointFloat(gb.buffer + readPointer, &endptr, rslt))
+	{
+		rslt = SafeStrtof(gb.buffer + readPointer, &endptr);
+	}
 	CheckNumberFound(endptr);
 	return rslt;
 }
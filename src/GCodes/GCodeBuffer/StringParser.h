@@ -13,6 +13,7 @@
 #include <GCodes/GCodeMachineState.h>
 #include <ObjectModel/ObjectModel.h>
 #include <GCodes/GCodeException.h>
+#include <GCodes/CompactGCode.h>
 #include <Networking/NetworkDefs.h>
 #include <Storage/CRC16.h>
 
@@ -20,6 +21,7 @@ class GCodeBuffer;
 class IPAddress;
 class MacAddress;
 class VariableSet;
+class CompiledExpression;
 
 class StringParser
 {
@@ -35,6 +37,13 @@ public:
 	void StartNewFile() noexcept;											// Called when we start a new file
 	bool FileEnded() noexcept;												// Called when we reach the end of the file we are reading from
 	bool CheckMetaCommand(const StringRef& reply) THROWS(GCodeException);	// Check whether the current command is a meta command, or we are skipping block
+#if SUPPORT_COMPILED_EXPRESSIONS
+	void ReleaseCompiledConditions() noexcept;								// Free the cache of compiled conditions
+#endif
+#if SUPPORT_COMPACT_GCODE
+	void PutCompactMove(int gCode, Bitmap<uint32_t> params, const float values[], size_t recordLength) noexcept;	// Store an already-parsed G0 or G1 command
+	bool IsAtStartOfLine() const noexcept;									// Return true if we have not received any characters of the next line yet
+#endif
 
 	// The following may be called after calling DecodeCommand
 	char GetCommandLetter() const noexcept { return commandLetter; }
@@ -121,9 +130,13 @@ private:
 	void ProcessEchoCommand(const StringRef& reply) THROWS(GCodeException);
 
 	bool EvaluateCondition() THROWS(GCodeException);
+#if SUPPORT_COMPILED_EXPRESSIONS
+	CompiledExpression *_ecv_null GetCompiledCondition(const char *_ecv_array text) noexcept;
+#endif
 
 	void SkipWhiteSpace() noexcept;
 	void FindParameters() noexcept;
+	bool ScanForParameter(char c, bool wantLowerCase) noexcept;
 
 	unsigned int commandStart;							// Index in the buffer of the command letter of this command
 	unsigned int parameterStart;
@@ -132,8 +145,15 @@ private:
 	unsigned int braceCount;							// how many nested { } we are inside
 	unsigned int gcodeLineEnd;							// Number of characters in the entire line of gcode
 	Bitmap<uint32_t> parametersPresent;					// which parameters are present in this command
+	uint16_t parameterOffsets[26];						// index in the buffer of one past the first occurrence of each upper case parameter letter, or 0 if absent
+	uint16_t lowerCaseParameterOffsets[26];				// index in the buffer of one past the first occurrence of each lower case (i.e. ' prefixed) parameter letter, or 0 if absent
 	int readPointer;									// Where in the buffer to read next, or -1
 
+#if SUPPORT_COMPILED_EXPRESSIONS
+	CompiledExpression *_ecv_array _ecv_null compiledConditions;	// cache of compiled if/while conditions, allocated when first needed
+	unsigned int nextCompiledCondition;				// index of the cache entry to replace next
+#endif
+
 	FileStore *fileBeingWritten;						// If we are copying GCodes to a file, which file it is
 	FilePosition writingFileSize;						// Size of the file being written, or zero if not known
 
@@ -163,6 +183,12 @@ private:
 	bool warnedAboutMixedSpacesAndTabs;
 	bool overflowed;
 	bool seenExpression;
+	bool parameterOffsetsValid;							// true if parameterOffsets and lowerCaseParameterOffsets describe the current command
+#if SUPPORT_COMPACT_GCODE
+	bool compactCommand;								// true if the current command came from a compact G-code move record, so the parameter values are in compactValues
+	uint8_t compactValueIndex;							// index into compactValues of the parameter found by the last call to Seen
+	float compactValues[CompactGCode::NumParameters];	// parameter values of the compact command, indexed as CompactGCode::ParameterLetters
+#endif
 
 	bool checksumRequired;								// True if we only accept commands with a valid checksum
 	bool crcRequired;									// True if we only accept commands with a valid CRC, except for M409 commands
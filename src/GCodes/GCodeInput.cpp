@@ -10,10 +10,15 @@
 #include <Platform/RepRap.h>
 #include "GCodes.h"
 #include "GCodeBuffer/GCodeBuffer.h"
+#include "CompactGCode.h"
 
 const size_t GCodeInputFileReadThreshold = 128;		// How many free bytes must be available before data is read from the file
 const size_t GCodeInputUSBReadThreshold = 128;		// How many free bytes must be available before we read more data from USB
 
+#if SUPPORT_COMPACT_GCODE
+static_assert(CompactGCode::MaxMoveRecordLength < GCodeInputFileReadThreshold, "A complete move record must always fit in the buffer");
+#endif
+
 // Read some input bytes into the GCode buffer. Return true if there is a line of GCode waiting to be processed.
 // This needs to be efficient
 bool StandardGCodeInput::FillBuffer(GCodeBuffer *gb) noexcept
@@ -250,11 +255,24 @@ bool NetworkGCodeInput::FillBuffer(GCodeBuffer *gb) noexcept /*override*/
 
 // File-based G-code input source
 
+FileGCodeInput::FileGCodeInput() noexcept : RegularGCodeInput()
+{
+#if SUPPORT_COMPACT_GCODE
+	reachedEndOfFile = badMoveRecord = false;
+#endif
+}
+
 // Reset this input. Should be called when the associated file is being closed
 void FileGCodeInput::Reset() noexcept
 {
+#if SUPPORT_FILE_PREFETCH
+	prefetcher.Detach();
+#endif
 	lastFileRead.Close();
 	RegularGCodeInput::Reset();
+#if SUPPORT_COMPACT_GCODE
+	reachedEndOfFile = badMoveRecord = false;
+#endif
 }
 
 // Reset this input. Should be called when a specific G-code or macro file is closed outside of the reading context
@@ -269,11 +287,24 @@ void FileGCodeInput::Reset(const FileData &file) noexcept
 // Read another chunk of G-codes from the file and return true if more data is available
 GCodeInputReadResult FileGCodeInput::ReadFromFile(FileData &file) noexcept
 {
+#if SUPPORT_COMPACT_GCODE
+	if (badMoveRecord)
+	{
+		// FillBuffer found a malformed move record, so make the caller abandon the file
+		badMoveRecord = false;
+		RegularGCodeInput::Reset();
+		return GCodeInputReadResult::error;
+	}
+#endif
+
 	const size_t bytesCached = BytesCached();
 
 	// Keep track of the last file we read from
 	if (lastFileRead.IsLive() && lastFileRead != file)
 	{
+#if SUPPORT_FILE_PREFETCH
+		prefetcher.Detach();									// this leaves the file positioned after the last byte that we copied into our buffer
+#endif
 		if (bytesCached > 0)
 		{
 			// Rewind back to the right position so we can resume at the right position later.
@@ -282,6 +313,9 @@ GCodeInputReadResult FileGCodeInput::ReadFromFile(FileData &file) noexcept
 		}
 
 		RegularGCodeInput::Reset();
+#if SUPPORT_COMPACT_GCODE
+		reachedEndOfFile = false;
+#endif
 	}
 	lastFileRead.CopyFrom(file);
 
@@ -294,24 +328,342 @@ GCodeInputReadResult FileGCodeInput::ReadFromFile(FileData &file) noexcept
 			readingPointer = writingPointer = 0;
 		}
 
-		// The code here used to read into a local buffer in blocks that are multiples of 4 bytes.
-		// However, unless we can use a buffer of at least 512 bytes then that is redundant,
-		// because the data will be copied via the sector buffer in FatFS anyway. So we don't do that any more.
-		const int bytesRead = file.Read(buffer + writingPointer, min<size_t>(BufferSpaceLeft(), GCodeInputBufferSize - writingPointer));
-		if (bytesRead < 0)
+		const size_t maxToRead = min<size_t>(BufferSpaceLeft(), GCodeInputBufferSize - writingPointer);
+#if SUPPORT_FILE_PREFETCH
+		// Long files are read ahead in large blocks by the prefetch task, so that we don't have to wait for the SD card each time our buffer runs low
+		if (!prefetcher.IsAttachedTo(file) && file.Length() >= FilePrefetchMinFileLength)
 		{
-			return GCodeInputReadResult::error;
+			prefetcher.Attach(file);
 		}
-		if (bytesRead > 0)
+
+		if (prefetcher.IsAttachedTo(file))
 		{
-			writingPointer = (writingPointer + (size_t)bytesRead) % GCodeInputBufferSize;
-			return GCodeInputReadResult::haveData;
+			const int bytesRead = prefetcher.Read(buffer + writingPointer, maxToRead);
+			if (bytesRead < 0)
+			{
+				return GCodeInputReadResult::error;
+			}
+			if (bytesRead > 0)
+			{
+				writingPointer = (writingPointer + (size_t)bytesRead) % GCodeInputBufferSize;
+				return GCodeInputReadResult::haveData;
+			}
+			if (!prefetcher.IsFinished())
+			{
+				return GCodeInputReadResult::haveData;			// the prefetch task hasn't read the next block yet, so try again later
+			}
+# if SUPPORT_COMPACT_GCODE
+			reachedEndOfFile = true;
+# endif
+		}
+		else
+#endif
+		{
+			// The code here used to read into a local buffer in blocks that are multiples of 4 bytes.
+			// However, unless we can use a buffer of at least 512 bytes then that is redundant,
+			// because the data will be copied via the sector buffer in FatFS anyway. So we don't do that any more.
+			const int bytesRead = file.Read(buffer + writingPointer, maxToRead);
+			if (bytesRead < 0)
+			{
+				return GCodeInputReadResult::error;
+			}
+#if SUPPORT_COMPACT_GCODE
+			reachedEndOfFile = (bytesRead == 0);
+#endif
+			if (bytesRead > 0)
+			{
+				writingPointer = (writingPointer + (size_t)bytesRead) % GCodeInputBufferSize;
+				return GCodeInputReadResult::haveData;
+			}
 		}
 	}
 
 	return (bytesCached > 0) ? GCodeInputReadResult::haveData : GCodeInputReadResult::noData;
 }
 
+// Get the file position of the next byte that FillBuffer will process
+FilePosition FileGCodeInput::GetPosition(const FileData &file) const noexcept
+{
+#if SUPPORT_FILE_PREFETCH
+	if (prefetcher.IsAttachedTo(file))
+	{
+		return prefetcher.GetPosition() - BytesCached();
+	}
+#endif
+	return file.GetPosition() - BytesCached();
+}
+
+#if SUPPORT_COMPACT_GCODE
+
+// Fill a GCodeBuffer with the last available G-code
+bool FileGCodeInput::FillBuffer(GCodeBuffer *gb) noexcept
+{
+	return (gb->LatestMachineState().compactFile
+#if HAS_MASS_STORAGE
+			&& !gb->IsWritingBinary()
+#endif
+		   )
+			? FillBufferFromCompactFile(gb)
+				: RegularGCodeInput::FillBuffer(gb);
+}
+
+// Return true if the file is in compact G-code format. The file position is left unchanged.
+/*static*/ bool FileGCodeInput::IsCompactFile(FileData &file) noexcept
+{
+	const FilePosition pos = file.GetPosition();
+	char buf[CompactGCode::SignatureLength];
+	const bool isCompact = file.Seek(0)
+						&& file.Read(buf, sizeof(buf)) == (int)sizeof(buf)
+						&& memcmp(buf, CompactGCode::Signature, sizeof(buf)) == 0;
+	file.Seek(pos);
+	return isCompact;
+}
+
+// Pass text lines from a compact G-code file to the GCodeBuffer in the usual way, but decode move records directly into it.
+// Return true if there is a command waiting to be processed.
+bool FileGCodeInput::FillBufferFromCompactFile(GCodeBuffer *gb) noexcept
+{
+	for (;;)
+	{
+		const size_t bytesCached = BytesCached();
+		if (bytesCached == 0)
+		{
+			return false;
+		}
+
+		const uint8_t tag = PeekByte(0);
+		if ((tag & CompactGCode::MoveRecordFlag) != 0 && gb->IsAtStartOfLine()
+#if HAS_MASS_STORAGE
+			&& !gb->IsWritingFile()
+#endif
+		   )
+		{
+			// It's a move record. Make sure that we have all of it before we start decoding it.
+			// If any byte of a value doesn't have the varint flag set (for example, it is a newline) or a value is too long then the file is corrupt.
+			// Abandon it, because otherwise we could wait for ever for the end of a record that doesn't fit in the buffer.
+			size_t recordLength = 1;
+			for (unsigned int i = 0; i < CompactGCode::NumParameters; ++i)
+			{
+				if ((tag & (1u << i)) != 0)
+				{
+					const size_t valueStart = recordLength;
+					uint8_t b;
+					do
+					{
+						if (recordLength - valueStart == CompactGCode::MaxVarintLength)
+						{
+							ReportBadMoveRecord(gb);
+							return false;
+						}
+						if (recordLength == bytesCached)
+						{
+							if (reachedEndOfFile)
+							{
+								// The file ends part way through a move record, so discard what we have of it
+								readingPointer = writingPointer;
+							}
+							return false;
+						}
+						b = PeekByte(recordLength++);
+						if ((b & CompactGCode::VarintByteFlag) == 0)
+						{
+							ReportBadMoveRecord(gb);
+							return false;
+						}
+					} while ((b & CompactGCode::VarintMoreFlag) != 0);
+				}
+			}
+
+			(void)ReadByte();								// skip the tag byte
+			Bitmap<uint32_t> params;
+			float values[CompactGCode::NumParameters];
+			for (unsigned int i = 0; i < CompactGCode::NumParameters; ++i)
+			{
+				if ((tag & (1u << i)) != 0)
+				{
+					uint32_t raw = 0;
+					unsigned int shift = 0;
+					uint8_t b;
+					do
+					{
+						b = (uint8_t)ReadByte();
+						if (shift < 32)
+						{
+							raw |= (uint32_t)(b & CompactGCode::VarintPayloadMask) << shift;
+						}
+						shift += CompactGCode::VarintPayloadBits;
+					} while ((b & CompactGCode::VarintMoreFlag) != 0);
+					values[i] = CompactGCode::DecodeValue(raw, i);
+					params.SetBit(CompactGCode::ParameterLetters[i] - 'A');
+				}
+				else
+				{
+					values[i] = 0.0;
+				}
+			}
+			gb->PutCompactMove(((tag & CompactGCode::G1Flag) != 0) ? 1 : 0, params, values, recordLength);
+			return true;
+		}
+
+		// It's part of a line of text
+		const char c = ReadByte();
+		if (gb->Put(c))										// process a character, returns true if a line of GCode is complete
+		{
+#if HAS_MASS_STORAGE
+			if (gb->IsWritingFile())
+			{
+				gb->WriteToFile();
+				continue;
+			}
+#endif
+			return true;
+		}
+	}
+}
+
+// Report a malformed move record in a compact G-code file and arrange for the file to be abandoned when ReadFromFile is next called
+void FileGCodeInput::ReportBadMoveRecord(const GCodeBuffer *gb) noexcept
+{
+	reprap.GetPlatform().MessageF(ErrorMessage, "%s: malformed move record in compact G-code file at line %" PRIi32 "\n", gb->GetChannel().ToString(), gb->GetLineNumber() + 1);
+	badMoveRecord = true;
+}
+
+#endif
+
+#if SUPPORT_OBJECT_SKIPPING
+
+// Decode a line that we may skip because it belongs to a cancelled object. Return false if it is not an unindented G0 or G1 command
+// whose only parameters are X, Y, Z, E and F given as plain numbers, optionally followed by a comment.
+// 'params' has a bit set for each parameter letter present, and 'values' has one entry for each letter in CompactGCode::ParameterLetters.
+static bool DecodeSkippableMove(const char *_ecv_array line, int& gCode, Bitmap<uint32_t>& params, float values[]) noexcept
+{
+	if (line[0] != 'G' || (line[1] != '0' && line[1] != '1') || isdigit(line[2]) || line[2] == '.')
+	{
+		return false;
+	}
+	gCode = line[1] - '0';
+
+	const char *_ecv_array p = line + 2;
+	for (;;)
+	{
+		while (*p == ' ' || *p == '\t' || *p == '\r')
+		{
+			++p;
+		}
+		if (*p == 0 || *p == ';')
+		{
+			return params.IsNonEmpty();
+		}
+
+		const char *_ecv_array const q = strchr(CompactGCode::ParameterLetters, *p);
+		if (q == nullptr || params.IsBitSet(*p - 'A'))
+		{
+			return false;
+		}
+		++p;
+		if (!isdigit(*p) && *p != '-' && *p != '.')
+		{
+			return false;								// not a plain number, e.g. an expression
+		}
+
+		const char *endptr;
+		values[q - CompactGCode::ParameterLetters] = SafeStrtof(p, &endptr);
+		if (endptr == p || (*endptr != 0 && *endptr != ' ' && *endptr != '\t' && *endptr != '\r' && *endptr != ';' && !isupper(*endptr)))
+		{
+			return false;
+		}
+		params.SetBit(*q - 'A');
+		p = endptr;
+	}
+}
+
+// Skip lines of the file being printed that belong to the current object, which has been cancelled, without passing them to the GCodeBuffer.
+// We stop at the first line that DecodeSkippableMove rejects. That includes comments, because they may label the next object or a new layer.
+// The skipped lines are replaced by a single move to the position that the last of them would have reached, so the user position stays correct.
+// Return true if the GCodeBuffer now holds that move, or false if we didn't skip anything.
+bool FileGCodeInput::SkipCancelledMoves(FileData &file, GCodeBuffer *gb) noexcept
+{
+	const bool relativeExtrusion = gb->LatestMachineState().drivesRelative;
+	Bitmap<uint32_t> params;
+	float values[CompactGCode::NumParameters] = { 0.0 };
+	int gCode = 1;
+	unsigned int linesSkipped = 0;
+	size_t lastLineLength = 0, bytesSkipped = 0;
+
+	while (bytesSkipped < CancelledObjectMaxSkipBytes)
+	{
+		// Make sure that we have the whole of the next line
+		const size_t bytesCached = BytesCached();
+		size_t lineLength = 0;
+		while (lineLength < bytesCached && lineLength <= MaxSkippedLineLength && PeekByte(lineLength) != '\n')
+		{
+			++lineLength;
+		}
+
+		if (lineLength > MaxSkippedLineLength)
+		{
+			break;
+		}
+
+		if (lineLength == bytesCached)
+		{
+			if (ReadFromFile(file) != GCodeInputReadResult::haveData || BytesCached() == bytesCached)
+			{
+				break;										// no more data is available yet, or we are at the end of the file
+			}
+			continue;
+		}
+
+		char line[MaxSkippedLineLength + 1];
+		for (size_t i = 0; i < lineLength; ++i)
+		{
+			line[i] = (char)PeekByte(i);
+		}
+		line[lineLength] = 0;
+
+		int lineGCode;
+		Bitmap<uint32_t> lineParams;
+		float lineValues[CompactGCode::NumParameters];
+		if (!DecodeSkippableMove(line, lineGCode, lineParams, lineValues))
+		{
+			break;
+		}
+
+		// Merge this move into the one that replaces the skipped lines. Relative extrusion amounts add up, everything else is absolute.
+		for (unsigned int i = 0; i < CompactGCode::NumParameters; ++i)
+		{
+			const unsigned int bit = CompactGCode::ParameterLetters[i] - 'A';
+			if (lineParams.IsBitSet(bit))
+			{
+				values[i] = (relativeExtrusion && CompactGCode::ParameterLetters[i] == 'E' && params.IsBitSet(bit))
+							? values[i] + lineValues[i]
+								: lineValues[i];
+			}
+		}
+		params |= lineParams;
+		gCode = lineGCode;
+
+		++lineLength;										// include the newline
+		readingPointer = (readingPointer + lineLength) % GCodeInputBufferSize;
+		bytesSkipped += lineLength;
+		lastLineLength = lineLength;
+		++linesSkipped;
+	}
+
+	if (linesSkipped == 0)
+	{
+		return false;
+	}
+
+	// PutCompactMove counts one line, and we want the line number to be the same as if we had processed all the lines we skipped.
+	// Passing the length of the last line skipped makes GetFilePosition return its start, so that a print paused here resumes from there.
+	gb->CurrentFileMachineState().lineNumber += linesSkipped - 1;
+	gb->PutCompactMove(gCode, params, values, lastLineLength);
+	return true;
+}
+
+#endif
+
 #endif
 
 // End
@@ -10,6 +10,7 @@
 
 #include <RepRapFirmware.h>
 #include <Storage/FileData.h>
+#include <Storage/FilePrefetcher.h>
 #include <RTOSIface/RTOSIface.h>
 
 #include <Stream.h>
@@ -109,15 +110,42 @@ class FileGCodeInput : public RegularGCodeInput
 {
 public:
 
-	FileGCodeInput() noexcept : RegularGCodeInput() { }
+	FileGCodeInput() noexcept;
 
 	void Reset() noexcept override;								// Clears the buffer. Should be called when the associated file is being closed
 	void Reset(const FileData &file) noexcept;					// Clears the buffer of a specific file. Should be called when it is closed or re-opened outside the reading context
 
 	GCodeInputReadResult ReadFromFile(FileData &file) noexcept;	// Read another chunk of G-codes from the file and return true if more data is available
+	FilePosition GetPosition(const FileData &file) const noexcept;	// Get the file position of the next byte that FillBuffer will process
+
+#if SUPPORT_COMPACT_GCODE
+	bool FillBuffer(GCodeBuffer *gb) noexcept override;			// Fill a GCodeBuffer with the last available G-code
+
+	static bool IsCompactFile(FileData &file) noexcept;			// Return true if the file is in compact G-code format
+#endif
+
+#if SUPPORT_OBJECT_SKIPPING
+	bool SkipCancelledMoves(FileData &file, GCodeBuffer *gb) noexcept;	// Skip moves of a cancelled object and store a single move that replaces them
+#endif
 
 private:
+#if SUPPORT_OBJECT_SKIPPING
+	static constexpr size_t MaxSkippedLineLength = 100;			// lines longer than this are never skipped
+#endif
+
+#if SUPPORT_COMPACT_GCODE
+	bool FillBufferFromCompactFile(GCodeBuffer *gb) noexcept;
+	void ReportBadMoveRecord(const GCodeBuffer *gb) noexcept;
+	uint8_t PeekByte(size_t offset) const noexcept { return (uint8_t)buffer[(readingPointer + offset) % GCodeInputBufferSize]; }
+
+	bool reachedEndOfFile;										// true if the last attempt to read from the file returned no data
+	bool badMoveRecord;											// true if FillBuffer found a malformed move record, so the file must be abandoned
+#endif
+
 	FileData lastFileRead;
+#if SUPPORT_FILE_PREFETCH
+	FilePrefetcher prefetcher;									// used to read ahead in long files, attached to lastFileRead if it is attached at all
+#endif
 };
 
 #endif
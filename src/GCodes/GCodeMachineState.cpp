@@ -23,6 +23,9 @@ GCodeMachineState::GCodeMachineState() noexcept
 	  waitingForAcknowledgement(false), messageAcknowledged(false), localPush(false), macroRestartable(false), firstCommandAfterRestart(false), commandRepeated(false),
 #if HAS_SBC_INTERFACE
 	  lastCodeFromSbc(false), macroStartedByCode(false), fileFinished(false),
+#endif
+#if SUPPORT_COMPACT_GCODE
+	  compactFile(false),
 #endif
 	  compatibility(Compatibility::RepRapFirmware),
 	  previous(nullptr), errorMessage(nullptr),
@@ -48,6 +51,9 @@ GCodeMachineState::GCodeMachineState(GCodeMachineState& prev, bool withinSameFil
 	  waitingForAcknowledgement(false), messageAcknowledged(false), localPush(withinSameFile), firstCommandAfterRestart(prev.firstCommandAfterRestart), commandRepeated(false),
 #if HAS_SBC_INTERFACE
 	  lastCodeFromSbc(prev.lastCodeFromSbc), macroStartedByCode(prev.macroStartedByCode), fileFinished(prev.fileFinished),
+#endif
+#if SUPPORT_COMPACT_GCODE
+	  compactFile(withinSameFile && prev.compactFile),
 #endif
 	  compatibility(prev.compatibility),
 	  previous(&prev), errorMessage(nullptr),
@@ -151,6 +157,9 @@ void GCodeMachineState::CloseFile() noexcept
 	{
 #if HAS_MASS_STORAGE || HAS_EMBEDDED_FILES
 		fileState.Close();
+#endif
+#if SUPPORT_COMPACT_GCODE
+		compactFile = false;
 #endif
 	}
 }
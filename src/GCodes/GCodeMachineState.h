@@ -235,6 +235,9 @@ public:
 		, lastCodeFromSbc : 1,
 		macroStartedByCode : 1,
 		fileFinished : 1
+#endif
+#if SUPPORT_COMPACT_GCODE
+		, compactFile : 1						// true if the file being executed is in compact G-code format
 #endif
 		;
 
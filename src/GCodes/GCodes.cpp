@@ -693,7 +693,11 @@ bool GCodes::DoFilePrint(GCodeBuffer& gb, const StringRef& reply) noexcept
 		switch (gb.GetFileInput()->ReadFromFile(fd))
 		{
 		case GCodeInputReadResult::haveData:
-			if (gb.GetFileInput()->FillBuffer(&gb))
+			if (
+#if SUPPORT_OBJECT_SKIPPING
+				SkipCancelledMoves(gb, fd) ||
+#endif
+				gb.GetFileInput()->FillBuffer(&gb))
 			{
 				bool done;
 				try
@@ -797,6 +801,26 @@ bool GCodes::DoFilePrint(GCodeBuffer& gb, const StringRef& reply) noexcept
 	return false;
 }
 
+#if SUPPORT_OBJECT_SKIPPING
+
+// If the current object in the file being printed has been cancelled, skip its moves without parsing them. Return true if gb now holds a command to execute.
+// Moves in a cancelled object only update the user position, so we replace a run of them by a single move to where the last one ends.
+// We don't do this in macros, inside conditional blocks, or when axis coordinates are relative.
+bool GCodes::SkipCancelledMoves(GCodeBuffer& gb, FileData& fd) noexcept
+{
+	return buildObjects.IsCurrentObjectCancelled()
+		&& &gb == fileGCode
+		&& gb.LatestMachineState().GetPrevious() == nullptr
+		&& !gb.LatestMachineState().axesRelative
+		&& !gb.LatestMachineState().compactFile
+		&& gb.GetBlockIndent() == 0
+		&& gb.IsAtStartOfLine()
+		&& !gb.IsWritingFile()
+		&& gb.GetFileInput()->SkipCancelledMoves(fd, &gb);
+}
+
+#endif
+
 // Restore positions etc. when exiting simulation mode
 void GCodes::EndSimulation(GCodeBuffer *gb) noexcept
 {
@@ -2014,6 +2038,7 @@ bool GCodes::DoStraightMove(GCodeBuffer& gb, bool isCoordinated, const char *& e
 	}
 
 	moveState.doingArcMove = false;
+	moveState.arcSegmentRadius = 0.0;
 	FinaliseMove(gb);
 	UnlockAll(gb);			// allow pause
 	err = nullptr;
@@ -2368,6 +2393,11 @@ bool GCodes::DoArcMove(GCodeBuffer& gb, bool clockwise, const char *& err)
 
 	moveState.arcAxis0 = axis0;
 	moveState.arcAxis1 = axis1;
+	// Tell the planner the smallest radius of curvature. If the axes are scaled differently then the arc becomes an ellipse with semi-axes arcRadius * maxScale and arcRadius * minScale,
+	// whose smallest radius of curvature is arcRadius * minScale^2/maxScale at the ends of the major axis.
+	const float minScale = min<float>(axisScaleFactors[axis0], axisScaleFactors[axis1]);
+	const float maxScale = max<float>(axisScaleFactors[axis0], axisScaleFactors[axis1]);
+	moveState.arcSegmentRadius = moveState.arcRadius * fsquare(minScale)/maxScale;
 	moveState.doingArcMove = true;
 	moveState.xyPlane = (selectedPlane == 0);
 	FinaliseMove(gb);
@@ -2678,7 +2708,7 @@ bool GCodes::DoFileMacro(GCodeBuffer& gb, const char* fileName, bool reportMissi
 #endif
 	{
 #if HAS_MASS_STORAGE || HAS_EMBEDDED_FILES
-		FileStore * const f = platform.OpenSysFile(fileName, OpenMode::read);
+		FileStore * const f = platform.OpenSysMacroFile(fileName);
 		if (f == nullptr)
 		{
 			if (reportMissing)
@@ -3159,6 +3189,9 @@ void GCodes::StartPrinting(bool fromStart) noexcept
 #if HAS_MASS_STORAGE || HAS_EMBEDDED_FILES
 		fileGCode->OriginalMachineState().fileState.MoveFrom(fileToPrint);
 		fileGCode->GetFileInput()->Reset(fileGCode->OriginalMachineState().fileState);
+# if SUPPORT_COMPACT_GCODE
+		fileGCode->OriginalMachineState().compactFile = FileGCodeInput::IsCompactFile(fileGCode->OriginalMachineState().fileState);
+# endif
 #endif
 	}
 	fileGCode->StartNewFile();
@@ -347,6 +347,9 @@ private:
 	void StopPrint(StopPrintReason reason) noexcept;							// Stop the current print
 
 	bool DoFilePrint(GCodeBuffer& gb, const StringRef& reply) noexcept;					// Get G Codes from a file and print them
+#if SUPPORT_OBJECT_SKIPPING
+	bool SkipCancelledMoves(GCodeBuffer& gb, FileData& fd) noexcept;					// Skip moves of a cancelled object in the file being printed
+#endif
 	bool DoFileMacro(GCodeBuffer& gb, const char* fileName, bool reportMissing, int codeRunning, VariableSet& initialVariables) noexcept;
 	bool DoFileMacro(GCodeBuffer& gb, const char* fileName, bool reportMissing, int codeRunning) noexcept;
 																						// Run a GCode macro file, optionally report error if not found
@@ -1193,6 +1193,10 @@ bool GCodes::HandleMcode(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeEx
 						{
 							reply.printf("Simulation mode: %s, move time: %.1f sec, other time: %.1f sec",
 									(IsSimulating()) ? "on" : "off", (double)reprap.GetMove().GetSimulationTime(), (double)simulationTime);
+							if (IsSimulating())
+							{
+								reprap.GetMove().AppendSimulationStats(reply);
+							}
 						}
 					}
 				}
@@ -3412,6 +3416,12 @@ bool GCodes::HandleMcode(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeEx
 						reprap.GetMove().SetJerkPolicy(gb.GetUIValue());
 					}
 
+					if (gb.Seen('J'))
+					{
+						seenAxis = true;
+						reprap.GetMove().SetJunctionDeviation(max<float>(gb.GetFValue(), 0.0));
+					}
+
 					if (seenAxis)
 					{
 						reprap.MoveUpdated();
@@ -3434,6 +3444,11 @@ bool GCodes::HandleMcode(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeEx
 						{
 							reply.catf(", jerk policy: %u", reprap.GetMove().GetJerkPolicy());
 						}
+						const float junctionDeviation = reprap.GetMove().GetJunctionDeviation();
+						if (junctionDeviation > 0.0)
+						{
+							reply.catf(", junction deviation: %.3fmm", (double)junctionDeviation);
+						}
 					}
 				}
 				break;
@@ -3755,7 +3770,7 @@ bool GCodes::HandleMcode(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeEx
 #endif
 
 			case 593: // Configure dynamic ringing cancellation
-				result = reprap.GetMove().GetAxisShaper().Configure(gb, reply);
+				result = reprap.GetMove().ConfigureInputShaping(gb, reply);
 				break;
 
 #if SUPPORT_ASYNC_MOVES
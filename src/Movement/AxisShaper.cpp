@@ -42,6 +42,7 @@ constexpr ObjectModelTableEntry AxisShaper::objectModelTable[] =
 	// Within each group, these entries must be in alphabetical order
 	// 0. InputShaper members
 	{ "amplitudes",				OBJECT_MODEL_FUNC_NOSELF(&amplitudesArrayDescriptor), 		ObjectModelEntryFlags::none },
+	{ "axes",					OBJECT_MODEL_FUNC(self->axes), 								ObjectModelEntryFlags::none },
 	{ "damping",				OBJECT_MODEL_FUNC(self->zeta, 2), 							ObjectModelEntryFlags::none },
 	{ "durations",				OBJECT_MODEL_FUNC_NOSELF(&durationsArrayDescriptor), 		ObjectModelEntryFlags::none },
 	{ "frequency",				OBJECT_MODEL_FUNC(self->frequency, 2), 						ObjectModelEntryFlags::none },
@@ -49,7 +50,7 @@ constexpr ObjectModelTableEntry AxisShaper::objectModelTable[] =
 	{ "type", 					OBJECT_MODEL_FUNC(self->type.ToString()), 					ObjectModelEntryFlags::none },
 };
 
-constexpr uint8_t AxisShaper::objectModelTableDescriptor[] = { 1, 6 };
+constexpr uint8_t AxisShaper::objectModelTableDescriptor[] = { 1, 7 };
 
 DEFINE_GET_OBJECT_MODEL_TABLE(AxisShaper)
 
@@ -189,6 +190,18 @@ GCodeResult AxisShaper::Configure(GCodeBuffer& gb, const StringRef& reply) THROW
 			numExtraImpulses = 2;
 			break;
 
+		case InputShaperType::zvstep4:
+			// Multi-step ZV-style shaper. The acceleration rises in four equal-length steps spanning one period of the specified frequency, with acceleration fractions 1/8, 3/8, 5/8 and 7/8.
+			// This is equivalent to five equally-spaced impulses of relative size 1:2:2:2:1, which cancel vibration at the specified frequency and at twice and three times that frequency.
+			// Jerk is not bounded, because each step is an instantaneous change of acceleration. The damping factor is not used.
+			for (unsigned int i = 0; i < MaxExtraImpulses; ++i)
+			{
+				coefficients[i] = (float)(2 * i + 1)/(float)(2 * MaxExtraImpulses);
+				durations[i] = (StepClockRate/frequency)/MaxExtraImpulses;
+			}
+			numExtraImpulses = MaxExtraImpulses;
+			break;
+
 		case InputShaperType::zvd:		// see https://www.researchgate.net/publication/316556412_INPUT_SHAPING_CONTROL_TO_REDUCE_RESIDUAL_VIBRATION_OF_A_FLEXIBLE_BEAM
 			{
 				const float j = fsquare(1.0 + k);
@@ -328,13 +341,24 @@ GCodeResult AxisShaper::Configure(GCodeBuffer& gb, const StringRef& reply) THROW
 
 		reprap.MoveUpdated();
 	}
-	else if (type == InputShaperType::none)
+	else
+	{
+		reply.Clear();
+		AppendDetails(reply);
+	}
+	return GCodeResult::ok;
+}
+
+// Append a description of the shaper to the reply
+void AxisShaper::AppendDetails(const StringRef& reply) const noexcept
+{
+	if (type == InputShaperType::none)
 	{
-		reply.copy("Input shaping is disabled");
+		reply.cat("Input shaping is disabled");
 	}
 	else
 	{
-		reply.printf("Input shaping '%s' at %.1fHz damping factor %.2f, min. acceleration %.1f",
+		reply.catf("Input shaping '%s' at %.1fHz damping factor %.2f, min. acceleration %.1f",
 						type.ToString(), (double)frequency, (double)zeta, (double)InverseConvertAcceleration(minimumAcceleration));
 		if (numExtraImpulses != 0)
 		{
@@ -358,12 +382,11 @@ GCodeResult AxisShaper::Configure(GCodeBuffer& gb, const StringRef& reply) THROW
 			}
 		}
 	}
-	return GCodeResult::ok;
 }
 
 // Plan input shaping, generate the MoveSegment, and set up the basic move parameters.
 // On entry, params.shapingPlan is set to 'no shaping'.
-// Currently we use a single input shaper for all axes, so the move segments are attached to the DDA not the DM
+// All the axes in a move use the same input shaper, chosen by Move::GetAxisShaperForMove, so the move segments are attached to the DDA not the DM
 void AxisShaper::PlanShaping(DDA& dda, PrepParams& params, bool shapingEnabled) const noexcept
 {
 	switch ((shapingEnabled) ? type.RawValue() : InputShaperType::none)
@@ -506,6 +529,7 @@ void AxisShaper::PlanShaping(DDA& dda, PrepParams& params, bool shapingEnabled)
 	case InputShaperType::zvddd:
 	case InputShaperType::ei2:
 	case InputShaperType::ei3:
+	case InputShaperType::zvstep4:
 		params.SetFromDDA(dda);															// set up the provisional parameters
 
 		if (params.unshaped.accelDistance < params.unshaped.decelStartDistance)			// we can't do any shaping unless there is a steady speed segment that can be shortened
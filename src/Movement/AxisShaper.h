@@ -28,6 +28,7 @@ NamedEnum(InputShaperType, uint8_t,
 	zvd,
 	zvdd,
 	zvddd,
+	zvstep4,
 );
 
 class DDA;
@@ -42,9 +43,12 @@ public:
 	float GetFrequency() const noexcept { return frequency; }
 	float GetDamping() const noexcept { return zeta; }
 	InputShaperType GetType() const noexcept { return type; }
+	AxesBitmap GetAxes() const noexcept { return axes; }
+	void SetAxes(AxesBitmap newAxes) noexcept { axes = newAxes; }
 	void PlanShaping(DDA& dda, PrepParams& params, bool shapingEnabled) const noexcept;
 
 	GCodeResult Configure(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException);	// process M593
+	void AppendDetails(const StringRef& reply) const noexcept;								// append a description of the shaper to the reply
 
 	static MoveSegment *GetUnshapedSegments(DDA& dda, const PrepParams& params) noexcept;
 
@@ -93,6 +97,7 @@ private:
 	float overlappedShapingClocks;						// the acceleration or deceleration duration when we use overlapping, in step clocks
 	float overlappedDeltaVPerA;							// the effective acceleration time (velocity change per unit acceleration) when we use overlapping, in step clocks
 	float overlappedDistancePerA;						// the distance needed by an overlapped acceleration or deceleration, less the initial velocity contribution
+	AxesBitmap axes;									// the axes that this shaper is dedicated to, or empty if it is the default shaper
 	InputShaperType type;
 };
 
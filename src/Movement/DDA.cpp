@@ -536,10 +536,23 @@ bool DDA::InitStandardMove(DDARing& ring, const RawMove &nextMove, bool doMotorM
 		k.LimitSpeedAndAcceleration(*this, normalisedDirectionVector, numVisibleAxes, flags.continuousRotationShortcut);	// give the kinematics the chance to further restrict the speed and acceleration
 	}
 
+	// If this is a segment of an arc, limit the speed so that the centripetal acceleration doesn't exceed the acceleration limit
+	beforePrepare.arcRadius = nextMove.arcSegmentRadius;
+	if (beforePrepare.arcRadius > 0.0)
+	{
+		const float maxArcSpeed = fastSqrtf(acceleration * beforePrepare.arcRadius);
+		if (maxArcSpeed < requestedSpeed)
+		{
+			requestedSpeed = maxArcSpeed;
+		}
+	}
+
 	// 7. Calculate the provisional accelerate and decelerate distances and the top speed
 	endSpeed = 0.0;							// until the next move asks us to adjust it
 
-	if (prev->state == provisional && (move.GetJerkPolicy() != 0 || (flags.isPrintingMove == prev->flags.isPrintingMove && flags.xyMoving == prev->flags.xyMoving)))
+	if (   prev->state == provisional && ring.GetPlannerMoves() == 0
+		&& (move.GetJerkPolicy() != 0 || (flags.isPrintingMove == prev->flags.isPrintingMove && flags.xyMoving == prev->flags.xyMoving))
+	   )
 	{
 		// Try to meld this move to the previous move to avoid stop/start
 		// Assuming that this move ends with zero speed, calculate the maximum possible starting speed: u^2 = v^2 - 2as
@@ -547,6 +560,11 @@ bool DDA::InitStandardMove(DDARing& ring, const RawMove &nextMove, bool doMotorM
 		DoLookahead(ring, prev);
 		startSpeed = prev->endSpeed;
 	}
+	else if (prev->state == provisional && ring.GetPlannerMoves() != 0 && CanJoinPrevious())
+	{
+		// Use the two-pass planner to recalculate the speeds of the moves in the queue
+		PlanProvisionalMoves(ring, ring.GetPlannerMoves());
+	}
 	else
 	{
 		// There is no previous move that we can adjust, so start at zero speed.
@@ -617,6 +635,7 @@ bool DDA::InitLeadscrewMove(DDARing& ring, float feedrate, const float adjustmen
 
 	// 6. Set the speed to the smaller of the requested and maximum speed.
 	requestedSpeed = feedrate;
+	beforePrepare.arcRadius = 0.0;
 
 	// 7. Calculate the provisional accelerate and decelerate distances and the top speed
 	startSpeed = endSpeed = 0.0;
@@ -667,6 +686,7 @@ bool DDA::InitAsyncMove(DDARing& ring, const AsyncMove& nextMove) noexcept
 	startSpeed = nextMove.startSpeed;
 	endSpeed = nextMove.endSpeed;
 	requestedSpeed = nextMove.requestedSpeed;
+	beforePrepare.arcRadius = 0.0;
 	acceleration = nextMove.acceleration;
 	deceleration = nextMove.deceleration;
 
@@ -939,15 +959,7 @@ pre(state == provisional)
 			{
 				const DDAState st = laDDA->prev->state;
 				// This is a deceleration-only move, and the previous one has a deceleration phase. We may have to adjust the previous move as well to get optimum behaviour.
-				if (   st == provisional
-					&& (   reprap.GetMove().GetJerkPolicy() != 0
-						|| (   laDDA->prev->flags.xyMoving == laDDA->flags.xyMoving
-							&& (   laDDA->prev->flags.isPrintingMove == laDDA->flags.isPrintingMove
-								|| (laDDA->prev->flags.isPrintingMove && laDDA->prev->requestedSpeed == laDDA->requestedSpeed)	// special case to support coast-to-end
-							   )
-						   )
-					   )
-				   )
+				if (st == provisional && laDDA->CanJoinPrevious())
 				{
 					laDDA->MatchSpeeds();
 					const float maxStartSpeed = fastSqrtf(fsquare(laDDA->beforePrepare.targetNextSpeed) + (2 * laDDA->deceleration * laDDA->totalDistance));
@@ -1050,6 +1062,66 @@ LA_DEBUG;
 	}
 }
 
+// Return true if this move may start at nonzero speed to match the end of the previous one
+bool DDA::CanJoinPrevious() const noexcept
+{
+	return reprap.GetMove().GetJerkPolicy() != 0
+		|| (   prev->flags.xyMoving == flags.xyMoving
+			&& (   prev->flags.isPrintingMove == flags.isPrintingMove
+				|| (prev->flags.isPrintingMove && prev->requestedSpeed == requestedSpeed)	// special case to support coast-to-end
+			   )
+		   );
+}
+
+// Recalculate the speeds of the un-prepared moves in the queue, ending with this move which has just been added and must end at zero speed.
+// This is the alternative to DoLookahead used when a planner depth has been configured using M595.
+// The backward pass finds the highest speed at which each move can end such that all subsequent moves can still decelerate to a stop by the end of this move.
+// It stops when it reaches a move that is no longer provisional, a junction that the moves are not allowed to join at speed, a move whose end speed cannot be improved,
+// or after maxMoves moves. The start speed of the earliest move reached is not changed.
+// The forward pass then limits each end speed to what can be reached from the start speed and recalculates the moves.
+void DDA::PlanProvisionalMoves(DDARing& ring, unsigned int maxMoves) noexcept
+pre(prev->state == provisional; maxMoves != 0)
+{
+	startSpeed = prev->endSpeed;										// in case we are unable to change the previous move
+	DDA *laDDA = this;
+	float maxEndSpeed = 0.0;											// this move must end at zero speed
+	for (unsigned int laDepth = 0; ; ++laDepth)
+	{
+		const float maxStartSpeed = min<float>(fastSqrtf(fsquare(maxEndSpeed) + (2 * laDDA->deceleration * laDDA->totalDistance)), laDDA->requestedSpeed);
+		DDA * const prevDDA = laDDA->prev;
+		const DDAState st = prevDDA->state;
+		if (st != provisional || laDepth == maxMoves || !laDDA->CanJoinPrevious())
+		{
+			// We can't adjust the previous move. If it has already been prepared and it has to slow down to meet this move, the queue was too short.
+			if ((st == frozen || st == executing) && prevDDA->endSpeed < prevDDA->topSpeed && laDDA->startSpeed < maxStartSpeed * 0.99)
+			{
+				laDDA->flags.hadLookaheadUnderrun = true;
+			}
+			break;
+		}
+
+		// Limit the speed at the junction to what the previous move and the jerk limits allow
+		const float junctionSpeed = prevDDA->GetJunctionSpeedLimit(min<float>(maxStartSpeed, prevDDA->requestedSpeed));
+		if (junctionSpeed <= prevDDA->endSpeed)
+		{
+			break;														// no improvement possible, so the earlier moves are already optimal and the previous move is left unchanged
+		}
+		prevDDA->beforePrepare.targetNextSpeed = junctionSpeed;
+		maxEndSpeed = junctionSpeed;
+		laDDA = prevDDA;
+	}
+
+	// Forward pass. The start speed of laDDA is fixed.
+	while (laDDA != this)
+	{
+		const float maxReachableSpeed = fastSqrtf(fsquare(laDDA->startSpeed) + (2 * laDDA->acceleration * laDDA->totalDistance));
+		laDDA->endSpeed = min<float>(laDDA->beforePrepare.targetNextSpeed, maxReachableSpeed);
+		laDDA->RecalculateMove(ring);
+		laDDA->next->startSpeed = laDDA->endSpeed;
+		laDDA = laDDA->next;
+	}
+}
+
 // Try to push babystepping earlier in the move queue, returning the amount we pushed
 // Caution! Thus is called with scheduling locked, therefore it must make no FreeRTOS calls, or call anything that makes them
 //TODO this won't work for CoreXZ, rotary delta, Kappa, or SCARA with Z crosstalk
@@ -1206,19 +1278,75 @@ void DDA::RecalculateMove(DDARing& ring) noexcept
 // On return, targetNextSpeed is the actual speed we can achieve without exceeding the jerk limits.
 void DDA::MatchSpeeds() noexcept
 {
+	beforePrepare.targetNextSpeed = GetJunctionSpeedLimit(beforePrepare.targetNextSpeed);
+}
+
+// Return the highest speed not exceeding targetSpeed at which this move can end and the next one start without exceeding the jerk limits.
+// If a junction deviation has been configured and both moves involve linear axes, the speed of the linear axes through the corner is limited by the
+// centripetal acceleration needed to follow an arc that deviates from the corner by the junction deviation, instead of by the per-axis jerk limits.
+// Junctions between segments of the same G2/G3 arc are not limited for the linear axes, because the arc curvature has already limited the speed of each segment.
+float DDA::GetJunctionSpeedLimit(float targetSpeed) const noexcept
+{
+	AxesBitmap junctionDeviationAxes;
+	const float junctionDeviation = reprap.GetMove().GetJunctionDeviation();
+	const bool sameArc = beforePrepare.arcRadius > 0.0 && next->beforePrepare.arcRadius == beforePrepare.arcRadius;
+	if (junctionDeviation > 0.0 || sameArc)
+	{
+		const AxesBitmap linearAxes = reprap.GetPlatform().GetLinearAxes();
+		float dotProduct = 0.0, thisMagnitudeSquared = 0.0, nextMagnitudeSquared = 0.0;
+		for (size_t axis = 0; axis < MaxAxes; ++axis)
+		{
+			if (linearAxes.IsBitSet(axis))
+			{
+				dotProduct += directionVector[axis] * next->directionVector[axis];
+				thisMagnitudeSquared += fsquare(directionVector[axis]);
+				nextMagnitudeSquared += fsquare(next->directionVector[axis]);
+			}
+		}
+
+		if (thisMagnitudeSquared > 0.0 && nextMagnitudeSquared > 0.0)
+		{
+			const float cosTheta = -dotProduct/fastSqrtf(thisMagnitudeSquared * nextMagnitudeSquared);	// theta is the angle between the two paths at the junction, so cosTheta is -1 for a straight line
+			if (sameArc && 1.0 + cosTheta <= 2.0 * fsquare(max<float>(totalDistance, next->totalDistance)/beforePrepare.arcRadius))
+			{
+				// Both moves are segments of the same arc and the change of direction is no more than about twice the angle that each one subtends, so this isn't a real corner.
+				// The speed of each segment has already been limited according to the curvature of the arc, so don't apply any further limit for the linear axes.
+				junctionDeviationAxes = linearAxes;
+			}
+			else if (junctionDeviation > 0.0)
+			{
+				junctionDeviationAxes = linearAxes;
+				if (cosTheta > 0.999999)
+				{
+					targetSpeed = 0.0;										// the path reverses
+				}
+				else if (cosTheta > -0.999999)
+				{
+					const float sinHalfTheta = fastSqrtf(0.5 * (1.0 - cosTheta));
+					const float maxSpeedSquared = min<float>(deceleration, next->acceleration) * junctionDeviation * sinHalfTheta/(1.0 - sinHalfTheta);
+					if (maxSpeedSquared < fsquare(targetSpeed))
+					{
+						targetSpeed = fastSqrtf(maxSpeedSquared);
+					}
+				}
+			}
+		}
+	}
+
 	for (size_t drive = 0; drive < MaxAxesPlusExtruders; ++drive)
 	{
-		if (directionVector[drive] != 0.0 || next->directionVector[drive] != 0.0)
+		if ((directionVector[drive] != 0.0 || next->directionVector[drive] != 0.0) && !(drive < MaxAxes && junctionDeviationAxes.IsBitSet(drive)))
 		{
 			const float totalFraction = fabsf(directionVector[drive] - next->directionVector[drive]);
-			const float jerk = totalFraction * beforePrepare.targetNextSpeed;
+			const float jerk = totalFraction * targetSpeed;
 			const float allowedJerk = reprap.GetPlatform().GetInstantDv(drive);
 			if (jerk > allowedJerk)
 			{
-				beforePrepare.targetNextSpeed = allowedJerk/totalFraction;
+				targetSpeed = allowedJerk/totalFraction;
 			}
 		}
 	}
+	return targetSpeed;
 }
 
 // This is called by Move::CurrentMoveCompleted to update the live coordinates from the move that has just finished
@@ -1308,7 +1436,7 @@ void DDA::Prepare(SimulationMode simMode) noexcept
 	PrepParams params;										// the default constructor clears params.plan to 'no shaping'
 	if (flags.xyMoving)
 	{
-		reprap.GetMove().GetAxisShaper().PlanShaping(*this, params, flags.xyMoving);	// this will set up shapedSegments if we are doing any shaping
+		reprap.GetMove().GetAxisShaperForMove(directionVector).PlanShaping(*this, params, flags.xyMoving);	// this will set up shapedSegments if we are doing any shaping
 	}
 	else
 	{
@@ -2123,21 +2251,27 @@ void DDA::StepDrivers(Platform& p, uint32_t now) noexcept
 
 // Simulate stepping the drivers, for debugging.
 // This is basically a copy of DDA::SetDrivers except that instead of being called from the timer ISR and generating steps,
-// it is called from the Move task and outputs info on the step timings. It ignores endstops.
-void DDA::SimulateSteppingDrivers(Platform& p) noexcept
+// it is called from the Move task and optionally outputs info on the step timings. It ignores endstops.
+// Return the number of steps generated, so that the caller can measure step generation throughput.
+unsigned int DDA::SimulateSteppingDrivers(Platform& p, bool printSteps) noexcept
 {
 	static uint32_t lastStepTime;
 	static bool checkTiming = false;
 
+	unsigned int numSteps = 0;
 	DriveMovement* dm = activeDMs;
 	if (dm != nullptr)
 	{
 		const uint32_t dueTime = dm->nextStepTime;
 		while (dm != nullptr && dueTime >= dm->nextStepTime)			// if the next step is due
 		{
-			const uint32_t timeDiff = dm->nextStepTime - lastStepTime;
-			const bool badTiming = checkTiming && (timeDiff < 10 || timeDiff > 100000000);
-			debugPrintf("%10" PRIu32 " D%u %c%s", dm->nextStepTime, dm->drive, (dm->direction) ? 'F' : 'B', (badTiming) ? " *\n" : "\n");
+			if (printSteps)
+			{
+				const uint32_t timeDiff = dm->nextStepTime - lastStepTime;
+				const bool badTiming = checkTiming && (timeDiff < 10 || timeDiff > 100000000);
+				debugPrintf("%10" PRIu32 " D%u %c%s", dm->nextStepTime, dm->drive, (dm->direction) ? 'F' : 'B', (badTiming) ? " *\n" : "\n");
+			}
+			++numSteps;
 			dm = dm->nextDM;
 		}
 		lastStepTime = dueTime;
@@ -2177,6 +2311,7 @@ void DDA::SimulateSteppingDrivers(Platform& p) noexcept
 		checkTiming = false;		// don't check the timing of the first step in the next move
 		state = completed;
 	}
+	return numSteps;
 }
 
 // Stop a drive and re-calculate the corresponding endpoint.
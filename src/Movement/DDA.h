@@ -100,7 +100,7 @@ public:
 
 	void Start(Platform& p, uint32_t tim) noexcept SPEED_CRITICAL;					// Start executing the DDA, i.e. move the move.
 	void StepDrivers(Platform& p, uint32_t now) noexcept SPEED_CRITICAL;			// Take one step of the DDA, called by timer interrupt.
-	void SimulateSteppingDrivers(Platform& p) noexcept;								// For debugging use
+	unsigned int SimulateSteppingDrivers(Platform& p, bool printSteps) noexcept;		// For debugging and profiling use, returns the number of steps generated
 	bool ScheduleNextStepInterrupt(StepTimer& timer) const noexcept SPEED_CRITICAL;	// Schedule the next interrupt, returning true if we can't because it is already due
 
 	void SetNext(DDA *n) noexcept { next = n; }
@@ -220,6 +220,8 @@ public:
 
 	static constexpr uint32_t UsualMinimumPreparedTime = StepClockRate/10;					// 100ms
 	static constexpr uint32_t AbsoluteMinimumPreparedTime = StepClockRate/20;				// 50ms
+	static constexpr uint32_t MaximumPreparedTime = StepClockRate/2;						// 500ms, the furthest ahead that DDARing will prepare moves after repeated underruns
+	static constexpr uint32_t PreparedTimeIncrement = StepClockRate/40;						// 25ms, how much DDARing adjusts its prepared time target by
 
 #if DDA_LOG_PROBE_CHANGES
 	static const size_t MaxLoggedProbePositions = 40;
@@ -242,6 +244,7 @@ private:
 	DriveMovement *FindActiveDM(size_t drive) const noexcept;				// find the DM for a drive if there is one but only if it is active
 	void RecalculateMove(DDARing& ring) noexcept SPEED_CRITICAL;
 	void MatchSpeeds() noexcept SPEED_CRITICAL;
+	float GetJunctionSpeedLimit(float targetSpeed) const noexcept SPEED_CRITICAL;
 	void StopDrive(size_t drive) noexcept;									// stop movement of a drive and recalculate the endpoint
 	void InsertDM(DriveMovement *dm) noexcept SPEED_CRITICAL;
 	void DeactivateDM(size_t drive) noexcept;
@@ -256,6 +259,8 @@ private:
 #endif
 
 	static void DoLookahead(DDARing& ring, DDA *laDDA) noexcept SPEED_CRITICAL;	// Try to smooth out moves in the queue
+	void PlanProvisionalMoves(DDARing& ring, unsigned int maxMoves) noexcept SPEED_CRITICAL;	// Recalculate the speeds of the un-prepared moves ending with this one
+	bool CanJoinPrevious() const noexcept;									// Return true if this move may start at nonzero speed to match the end of the previous one
     static float Normalise(float v[], AxesBitmap unitLengthAxes) noexcept;  // Normalise a vector to unit length over the specified axes
     static float Normalise(float v[]) noexcept; 							// Normalise a vector to unit length over all axes
 	float NormaliseLinearMotion(AxesBitmap linearAxes) noexcept;			// Make the direction vector unit-normal in XYZ
@@ -332,6 +337,7 @@ private:
 			float decelDistance;
 			float targetNextSpeed;					// The speed that the next move would like to start at, used to keep track of the lookahead without making recursive calls
 			float maxAcceleration;					// the maximum allowed acceleration for this move according to the limits set by M201
+			float arcRadius;						// if this move is a segment of an arc, the arc radius, else zero
 		} beforePrepare;
 
 		// Values that are not set or accessed before Prepare is called
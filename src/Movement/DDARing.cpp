@@ -32,20 +32,25 @@ constexpr ObjectModelTableEntry DDARing::objectModelTable[] =
 	// 0. DDARing members
 	{ "gracePeriod",			OBJECT_MODEL_FUNC(self->gracePeriod * MillisToSeconds, 3),			ObjectModelEntryFlags::none },
 	{ "length",					OBJECT_MODEL_FUNC((int32_t)self->numDdasInRing), 					ObjectModelEntryFlags::none },
+	{ "maxLength",				OBJECT_MODEL_FUNC((int32_t)self->maxDdasInRing), 					ObjectModelEntryFlags::none },
+	{ "moveRate",				OBJECT_MODEL_FUNC((int32_t)self->GetMoveRate()), 					ObjectModelEntryFlags::live },
+	{ "plannerMoves",			OBJECT_MODEL_FUNC((int32_t)self->plannerMoves), 					ObjectModelEntryFlags::none },
+	{ "preparedTime",			OBJECT_MODEL_FUNC((float)self->preparedTimeTarget * (1.0/StepClockRate), 3),	ObjectModelEntryFlags::live },
 };
 
-constexpr uint8_t DDARing::objectModelTableDescriptor[] = { 1, 2 };
+constexpr uint8_t DDARing::objectModelTableDescriptor[] = { 1, 6 };
 
 DEFINE_GET_OBJECT_MODEL_TABLE(DDARing)
 
-DDARing::DDARing() noexcept : gracePeriod(DefaultGracePeriod), scheduledMoves(0), completedMoves(0), numHiccups(0)
+DDARing::DDARing() noexcept : gracePeriod(DefaultGracePeriod), plannerMoves(0), scheduledMoves(0), completedMoves(0), numHiccups(0)
 {
 }
 
 // This can be called in the constructor for class Move
-void DDARing::Init1(unsigned int numDdas) noexcept
+void DDARing::Init1(unsigned int numDdas, unsigned int maxDdas) noexcept
 {
 	numDdasInRing = numDdas;
+	maxDdasInRing = max<unsigned int>(numDdas, maxDdas);
 
 	// Build the DDA ring
 	DDA *dda = new DDA(nullptr);
@@ -70,7 +75,10 @@ void DDARing::Init2() noexcept
 {
 	stepErrors = 0;
 	numLookaheadUnderruns = numPrepareUnderruns = numNoMoveUnderruns = numLookaheadErrors = 0;
-	waitingForRingToEmpty = false;
+	whenPreparedTimeTargetAdjusted = millis();
+	waitingForRingToEmpty = hadPrepareUnderrun = false;
+	averageMoveClocks = 0;
+	preparedTimeTarget = DDA::UsualMinimumPreparedTime;
 
 	// Put the origin on the lookahead ring with default velocity in the previous position to the first one that will be used.
 	// Do this by calling SetLiveCoordinates and SetPositions, so that the motor coordinates will be correct too even on a delta.
@@ -90,7 +98,7 @@ void DDARing::Init2() noexcept
 		macc = 0;
 	}
 	extrudersPrinting = false;
-	simulationTime = 0.0;
+	ResetSimulationTime();
 }
 
 void DDARing::Exit() noexcept
@@ -119,13 +127,29 @@ GCodeResult DDARing::ConfigureMovementQueue(GCodeBuffer& gb, const StringRef& re
 	gb.TryGetUIValue('P', numDdasWanted, seen);
 	gb.TryGetUIValue('S', numDMsWanted, seen);
 	gb.TryGetUIValue('R', gracePeriod, seen);
-	if (seen)
+	uint32_t newPlannerMoves = plannerMoves;
+	gb.TryGetLimitedUIValue('L', newPlannerMoves, seen, MaxPlannerMoves + 1);
+	bool seenMaxDdas = false;
+	uint32_t newMaxDdas = maxDdasInRing;
+	gb.TryGetLimitedUIValue('A', newMaxDdas, seenMaxDdas, MaxAdaptiveDdaRingLength + 1);
+	if (seen || seenMaxDdas)
 	{
 		if (!reprap.GetGCodes().LockMovementAndWaitForStandstill(gb))
 		{
 			return GCodeResult::notFinished;
 		}
 
+		// The ring never shrinks, so the maximum length can't be less than the length it will have after this command
+		const unsigned int newNumDdas = max<unsigned int>(numDdasWanted, numDdasInRing);
+		if (seenMaxDdas && newMaxDdas < newNumDdas)
+		{
+			reply.printf("maximum queue length must be at least the queue length (%u)", newNumDdas);
+			return GCodeResult::error;
+		}
+
+		plannerMoves = newPlannerMoves;								// safe to change now because there are no provisional moves in the ring
+		maxDdasInRing = max<unsigned int>(newMaxDdas, newNumDdas);
+
 		ptrdiff_t memoryNeeded = 0;
 		if (numDdasWanted > numDdasInRing)
 		{
@@ -164,7 +188,16 @@ GCodeResult DDARing::ConfigureMovementQueue(GCodeBuffer& gb, const StringRef& re
 	}
 	else
 	{
-		reply.printf("DDAs %u, DMs %u, GracePeriod %" PRIu32, numDdasInRing, DriveMovement::NumCreated(), gracePeriod);
+		reply.printf("DDAs %u (max %u), DMs %u, GracePeriod %" PRIu32 ", move rate %" PRIu32 "/sec, prepare ahead %" PRIu32 "ms, planner ",
+						numDdasInRing, maxDdasInRing, DriveMovement::NumCreated(), gracePeriod, GetMoveRate(), preparedTimeTarget/(StepClockRate/1000));
+		if (plannerMoves == 0)
+		{
+			reply.cat("incremental");
+		}
+		else
+		{
+			reply.catf("two-pass up to %u moves", plannerMoves);
+		}
 	}
 	return GCodeResult::ok;
 }
@@ -272,12 +305,16 @@ uint32_t DDARing::Spin(SimulationMode simulationMode, bool waitingForSpace, bool
 	if (simulationMode != SimulationMode::off && cdda != nullptr)
 	{
 		simulationTime += (float)cdda->GetClocksNeeded() * (1.0/StepClockRate);
-		if (simulationMode == SimulationMode::debug && reprap.Debug(moduleDda))
+		if (simulationMode == SimulationMode::debug)
 		{
+			// Generate the steps for this move and measure how long it takes. The time includes printing the step timeline if DDA debug is enabled.
+			const bool printSteps = reprap.Debug(moduleDda);
+			const uint32_t startTime = StepTimer::GetTimerTicks();
 			do
 			{
-				cdda->SimulateSteppingDrivers(reprap.GetPlatform());
+				simulatedSteps += cdda->SimulateSteppingDrivers(reprap.GetPlatform(), printSteps);
 			} while (cdda->GetState() != DDA::completed);
+			simulatedStepClocks += StepTimer::GetTimerTicks() - startTime;
 		}
 		else
 		{
@@ -406,19 +443,39 @@ uint32_t DDARing::Spin(SimulationMode simulationMode, bool waitingForSpace, bool
 // Return the maximum time in milliseconds that should elapse before we prepare further unprepared moves that are already in the ring, or TaskBase::TimeoutUnlimited if there are no unprepared moves left.
 uint32_t DDARing::PrepareMoves(DDA *firstUnpreparedMove, int32_t moveTimeLeft, unsigned int alreadyPrepared, SimulationMode simulationMode) noexcept
 {
+	AdaptLookahead();
+
 	// If the number of prepared moves will execute in less than the minimum time, prepare another move.
 	// Try to avoid preparing deceleration-only moves too early
 	while (	  firstUnpreparedMove->GetState() == DDA::provisional
-		   && moveTimeLeft < (int32_t)DDA::UsualMinimumPreparedTime		// prepare moves one tenth of a second ahead of when they will be needed
+		   && moveTimeLeft < (int32_t)preparedTimeTarget				// prepare moves at least one tenth of a second ahead of when they will be needed
 		   && alreadyPrepared * 2 < numDdasInRing						// but don't prepare more than half the ring, to handle accelerate/decelerate moves in small segments
-		   && (firstUnpreparedMove->IsGoodToPrepare() || moveTimeLeft < (int32_t)DDA::AbsoluteMinimumPreparedTime)
+		   && (firstUnpreparedMove->IsGoodToPrepare() || moveTimeLeft < (int32_t)(preparedTimeTarget/2))
 #if SUPPORT_CAN_EXPANSION
 		   && CanMotion::CanPrepareMove()
 #endif
 		  )
 	{
-		firstUnpreparedMove->Prepare(simulationMode);
+		if (simulationMode != SimulationMode::off)
+		{
+			// When simulating, record how long it takes to prepare each move
+			const uint32_t startTime = StepTimer::GetTimerTicks();
+			firstUnpreparedMove->Prepare(simulationMode);
+			const uint32_t prepareClocks = StepTimer::GetTimerTicks() - startTime;
+			simulatedPrepareClocks += prepareClocks;
+			if (prepareClocks > maxSimulatedPrepareClocks)
+			{
+				maxSimulatedPrepareClocks = prepareClocks;
+			}
+			++simulatedMovesPrepared;
+		}
+		else
+		{
+			firstUnpreparedMove->Prepare(simulationMode);
+		}
 		moveTimeLeft += firstUnpreparedMove->GetTimeLeft();
+		const uint32_t moveClocks = min<uint32_t>(firstUnpreparedMove->GetClocksNeeded(), StepClockRate);
+		averageMoveClocks = (averageMoveClocks == 0) ? moveClocks : (averageMoveClocks * 15 + moveClocks)/16;
 		++alreadyPrepared;
 		firstUnpreparedMove = firstUnpreparedMove->GetNext();
 	}
@@ -432,7 +489,7 @@ uint32_t DDARing::PrepareMoves(DDA *firstUnpreparedMove, int32_t moveTimeLeft, u
 			return 1;
 		}
 
-		const int32_t clocksTillWakeup = moveTimeLeft - (int32_t)DDA::UsualMinimumPreparedTime;						// calculate how long before we run out of prepared moves, less the usual advance prepare time
+		const int32_t clocksTillWakeup = moveTimeLeft - (int32_t)preparedTimeTarget;								// calculate how long before we run out of prepared moves, less the advance prepare time
 		return (clocksTillWakeup <= 0) ? 2 : min<uint32_t>((uint32_t)clocksTillWakeup/(StepClockRate/1000), 2);		// wake up at that time, but delay for at least 2 ticks
 	}
 
@@ -440,6 +497,49 @@ uint32_t DDARing::PrepareMoves(DDA *firstUnpreparedMove, int32_t moveTimeLeft, u
 	return TaskBase::TimeoutUnlimited;
 }
 
+// Adjust how far ahead we prepare moves and how many moves the ring can hold, based on the moves we have been seeing.
+// If the step ISR ran out of prepared moves, prepare further ahead; then let the target decay back to the usual value slowly.
+// If the moves are so short that the ring holds less than AdaptiveLookaheadTime of movement, add a DDA to the ring if we have RAM to spare.
+void DDARing::AdaptLookahead() noexcept
+{
+	const uint32_t now = millis();
+	if (hadPrepareUnderrun)
+	{
+		hadPrepareUnderrun = false;
+		preparedTimeTarget = min<uint32_t>(preparedTimeTarget + DDA::PreparedTimeIncrement, DDA::MaximumPreparedTime);
+		whenPreparedTimeTargetAdjusted = now;
+	}
+	else if (preparedTimeTarget > DDA::UsualMinimumPreparedTime && now - whenPreparedTimeTargetAdjusted >= 1000)
+	{
+		preparedTimeTarget -= DDA::PreparedTimeIncrement;
+		whenPreparedTimeTargetAdjusted = now;
+	}
+
+	// We can only insert a new DDA after addPointer if the following DDA is not in use, because nothing refers to free DDAs other than addPointer.
+	// The step ISR never looks beyond addPointer, so we don't need to disable interrupts.
+	if (   numDdasInRing < maxDdasInRing
+		&& averageMoveClocks != 0
+		&& (uint64_t)numDdasInRing * averageMoveClocks < (uint64_t)AdaptiveLookaheadTime * (StepClockRate/1000)
+		&& addPointer->GetNext() != checkPointer
+		&& addPointer->GetNext()->GetState() == DDA::empty
+		&& Tasks::GetNeverUsedRam() > AdaptiveRingRamReserve + (ptrdiff_t)(sizeof(DDA) + 8)
+	   )
+	{
+		DDA * const newDda = new DDA(addPointer->GetNext());
+		newDda->SetPrevious(addPointer);
+		addPointer->GetNext()->SetPrevious(newDda);
+		addPointer->SetNext(newDda);
+		++numDdasInRing;
+		reprap.MoveUpdated();
+	}
+}
+
+// Return the recent average number of moves per second
+uint32_t DDARing::GetMoveRate() const noexcept
+{
+	return (averageMoveClocks == 0) ? 0 : StepClockRate/averageMoveClocks;
+}
+
 // Return true if this DDA ring is idle
 bool DDARing::IsIdle() const noexcept
 {
@@ -552,6 +652,7 @@ void DDARing::OnMoveCompleted(DDA *cdda, Platform& p) noexcept
 		if (st == DDA::provisional)
 		{
 			++numPrepareUnderruns;					// there are more moves available, but they are not prepared yet. Signal an underrun.
+			hadPrepareUnderrun = true;
 		}
 		else if (!waitingForRingToEmpty)
 		{
@@ -965,6 +1066,26 @@ void DDARing::Diagnostics(MessageType mtype, const char *prefix) noexcept
 	numHiccups = stepErrors = numLookaheadUnderruns = numPrepareUnderruns = numNoMoveUnderruns = numLookaheadErrors = 0;
 }
 
+// Reset the accumulated simulation time and the motion engine profiling statistics
+void DDARing::ResetSimulationTime() noexcept
+{
+	simulationTime = 0.0;
+	simulatedPrepareClocks = simulatedStepClocks = 0;
+	simulatedSteps = 0;
+	simulatedMovesPrepared = 0;
+	maxSimulatedPrepareClocks = 0;
+}
+
+// Append the statistics gathered since simulation was last started with M37 S1.
+// The output is a single line with a fixed field order so that the results of different runs or firmware builds can be compared directly:
+//  "\nMotion stats: clock <step clock rate> moves <moves prepared> prepare <total clocks> max <max clocks per move> steps <steps generated> stepgen <total clocks>"
+// All times are in step clocks. Fields are never omitted; new fields may only be appended at the end.
+void DDARing::AppendSimulationStats(const StringRef& reply) const noexcept
+{
+	reply.catf("\nMotion stats: clock %" PRIu32 " moves %" PRIu32 " prepare %" PRIu64 " max %" PRIu32 " steps %" PRIu64 " stepgen %" PRIu64,
+				StepClockRate, simulatedMovesPrepared, simulatedPrepareClocks, maxSimulatedPrepareClocks, simulatedSteps, simulatedStepClocks);
+}
+
 #if SUPPORT_LASER
 
 // Manage the laser power. Return the number of ticks until we should be called again, or 0 to be called at the start of the next move.
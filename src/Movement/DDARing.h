@@ -17,7 +17,7 @@ class DDARing INHERIT_OBJECT_MODEL
 public:
 	DDARing() noexcept;
 
-	void Init1(unsigned int numDdas) noexcept;
+	void Init1(unsigned int numDdas, unsigned int maxDdas) noexcept;
 	void Init2() noexcept;
 	void Exit() noexcept;
 
@@ -32,6 +32,7 @@ public:
 	uint32_t Spin(SimulationMode simulationMode, bool waitingForSpace, bool shouldStartMove) noexcept SPEED_CRITICAL;	// Try to process moves in the ring
 	bool IsIdle() const noexcept;														// Return true if this DDA ring is idle
 	uint32_t GetGracePeriod() const noexcept { return gracePeriod; }					// Return the minimum idle time, before we should start a move. Better to have a few moves in the queue so that we can do lookahead
+	unsigned int GetPlannerMoves() const noexcept { return plannerMoves; }				// Return the maximum number of moves the two-pass planner may adjust, or 0 if using incremental lookahead
 
 	float PushBabyStepping(size_t axis, float amount) noexcept;							// Try to push some babystepping through the lookahead queue, returning the amount pushed
 
@@ -48,7 +49,8 @@ public:
 	void ResetMoveCounters() noexcept { scheduledMoves = completedMoves = 0; }
 
 	float GetSimulationTime() const noexcept { return simulationTime; }
-	void ResetSimulationTime() noexcept { simulationTime = 0.0; }
+	void ResetSimulationTime() noexcept;
+	void AppendSimulationStats(const StringRef& reply) const noexcept;					// Append the step generation and move preparation statistics gathered while simulating
 
 #if HAS_SMART_DRIVERS
 	uint32_t GetStepInterval(size_t axis, uint32_t microstepShift) const noexcept;
@@ -100,6 +102,8 @@ protected:
 private:
 	bool StartNextMove(Platform& p, uint32_t startTime) noexcept SPEED_CRITICAL;		// Start the next move, returning true if laser or IObits need to be controlled
 	uint32_t PrepareMoves(DDA *firstUnpreparedMove, int32_t moveTimeLeft, unsigned int alreadyPrepared, SimulationMode simulationMode) noexcept;
+	void AdaptLookahead() noexcept;												// Adjust the prepared time target and the ring length to suit the moves we are seeing
+	uint32_t GetMoveRate() const noexcept;										// Return the recent average number of moves per second
 
 	static void TimerCallback(CallbackParameter p) noexcept;
 
@@ -114,7 +118,13 @@ private:
 	volatile int32_t liveEndPoints[MaxAxesPlusExtruders];						// The XYZ endpoints of the last completed move in motor coordinates
 
 	unsigned int numDdasInRing;
+	unsigned int maxDdasInRing;													// The ring may grow up to this many DDAs when the moves are short
+	uint32_t averageMoveClocks;													// Moving average of the durations of the moves we have prepared recently, in step clocks
+	uint32_t preparedTimeTarget;												// How far ahead we currently aim to prepare moves, in step clocks
+	uint32_t whenPreparedTimeTargetAdjusted;									// The millis() time when we last reduced preparedTimeTarget
+	volatile bool hadPrepareUnderrun;											// Set by the ISR when it wanted a move but the next one wasn't prepared
 	uint32_t gracePeriod;														// The minimum idle time in milliseconds, before we should start a move. Better to have a few moves in the queue so that we can do lookahead
+	unsigned int plannerMoves;													// The maximum number of previous moves that the two-pass planner may adjust when a move is added, or 0 to use incremental lookahead
 
 	uint32_t scheduledMoves;													// Move counters for the code queue
 	volatile uint32_t completedMoves;											// This one is modified by an ISR, hence volatile
@@ -127,6 +137,11 @@ private:
 	unsigned int stepErrors;													// count of step errors, for diagnostics
 
 	float simulationTime;														// Print time since we started simulating
+	uint64_t simulatedPrepareClocks;											// Total step clocks spent in DDA::Prepare while simulating
+	uint64_t simulatedStepClocks;												// Total step clocks spent generating steps in debug simulation mode
+	uint64_t simulatedSteps;													// Total steps generated in debug simulation mode
+	uint32_t simulatedMovesPrepared;											// Number of moves prepared while simulating
+	uint32_t maxSimulatedPrepareClocks;											// Longest time taken by DDA::Prepare while simulating
 	volatile int32_t movementAccumulators[MaxAxesPlusExtruders]; 				// Accumulated motor steps, used by filament monitors
 	volatile uint32_t extrudersPrintingSince;									// The milliseconds clock time when extrudersPrinting was set to true
 
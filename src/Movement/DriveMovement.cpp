@@ -23,6 +23,13 @@ static_assert(((int64_t)-10000000001 >> 1) == (int64_t)-5000000001);
 
 #endif
 
+#if SUPPORT_LINEAR_DELTA && MS_USE_FPU && DM_USE_DELTA_POLYNOMIAL
+
+constexpr uint32_t DeltaPolynomialMinSteps = 32;			// don't bother fitting a polynomial to delta segments with fewer steps than this
+constexpr float DeltaPolynomialTolerance = 0.02;			// the maximum error allowed in the polynomial approximation, in units of head movement * steps/mm
+
+#endif
+
 // Static members
 
 DriveMovement *DriveMovement::freeList = nullptr;
@@ -57,7 +64,7 @@ DriveMovement *DriveMovement::Allocate(size_t p_drive, DMState st) noexcept
 }
 
 // Constructors
-DriveMovement::DriveMovement(DriveMovement *next) noexcept : nextDM(next)
+DriveMovement::DriveMovement(DriveMovement *next) noexcept : nextDM(next), ownSegments(nullptr)
 {
 }
 
@@ -74,8 +81,9 @@ void DriveMovement::DebugPrint() const noexcept
 							(double)pA, (double)pB, (double)pC, (double)distanceSoFar, (double)timeSoFar);
 		if (isDelta)
 		{
-			debugPrintf(" hmz0s=%.4e minusAaPlusBbTimesS=%.4e dSquaredMinusAsquaredMinusBsquared=%.4e drev=%.4e\n",
-							(double)mp.delta.fHmz0s, (double)mp.delta.fMinusAaPlusBbTimesS, (double)mp.delta.fDSquaredMinusAsquaredMinusBsquaredTimesSsquared, (double)mp.delta.reverseStartDistance);
+			debugPrintf(" hmz0s=%.4e minusAaPlusBbTimesS=%.4e dSquaredMinusAsquaredMinusBsquared=%.4e drev=%.4e poly=%c\n",
+							(double)mp.delta.fHmz0s, (double)mp.delta.fMinusAaPlusBbTimesS, (double)mp.delta.fDSquaredMinusAsquaredMinusBsquaredTimesSsquared, (double)mp.delta.reverseStartDistance,
+								(useDeltaPolynomial) ? 'Y' : 'N');
 		}
 		else if (isExtruder)
 		{
@@ -313,6 +321,67 @@ bool DriveMovement::NewDeltaSegment(const DDA& dda) noexcept
 	}
 }
 
+# if MS_USE_FPU && DM_USE_DELTA_POLYNOMIAL
+
+// Calculate the exact distance moved * steps/mm for a given carriage height above Z in steps. Return false if there is no valid solution.
+// The result may be slightly negative at the start of the move due to rounding error.
+bool DriveMovement::CalcDeltaDistance(const DDA& dda, float hmz0s, float& ds) const noexcept
+{
+	const float t1 = mp.delta.fMinusAaPlusBbTimesS + hmz0s * dda.directionVector[Z_AXIS];
+	const float t2a = mp.delta.fDSquaredMinusAsquaredMinusBsquaredTimesSsquared - fsquare(hmz0s) + fsquare(t1);
+	if (t2a <= 0.0)
+	{
+		return false;
+	}
+	const float t2 = fastSqrtf(t2a);
+	ds = (direction) ? t1 - t2 : t1 + t2;
+	return true;
+}
+
+// Try to approximate the distance moved by a quadratic in the carriage height over the whole of a move that doesn't reverse. This is called from PrepareDeltaAxis.
+// We fit the quadratic through the start, middle and end points and accept it only if the worst-case error over the whole move is within tolerance.
+// The exact solution is ds(h) = t1(h) -/+ sqrt(Q(h)) where t1 is linear in h and Q(h) = K + t1(h)^2 - h^2 is quadratic,
+// so the third derivative of ds is -/+ 3 * delta * Q'(h)/(8 * Q(h)^2.5) where delta = 2 * Q * Q'' - Q'^2 is a constant.
+// Q'' = 2 * (dz^2 - 1) <= 0 so Q is concave, therefore over the move |Q'(h)| is largest and Q(h) is smallest at one of the ends.
+// The error of a quadratic through three equally-spaced points spanning r is at most max|third derivative of ds| * r^3/(72 * sqrt(3)).
+// Return true if the approximation is good enough to use, in which case the coefficients have been stored.
+bool DriveMovement::FitDeltaPolynomial(const DDA& dda) noexcept
+{
+	const float anchor = mp.delta.fHmz0s;
+	const float range = (direction) ? (float)totalSteps : -(float)totalSteps;
+
+	float f0, fm, f1;
+	if (   !CalcDeltaDistance(dda, anchor, f0)
+		|| !CalcDeltaDistance(dda, anchor + 0.5 * range, fm)
+		|| !CalcDeltaDistance(dda, anchor + range, f1)
+	   )
+	{
+		return false;
+	}
+
+	// Bound the approximation error
+	const float dz = dda.directionVector[Z_AXIS];
+	const float a = mp.delta.fMinusAaPlusBbTimesS;
+	const float k = mp.delta.fDSquaredMinusAsquaredMinusBsquaredTimesSsquared;
+	const float hEnd = anchor + range;
+	const float qMin = min<float>(k + fsquare(a + dz * anchor) - fsquare(anchor), k + fsquare(a + dz * hEnd) - fsquare(hEnd));
+	const float dqMax = 2.0 * max<float>(fabsf(dz * (a + dz * anchor) - anchor), fabsf(dz * (a + dz * hEnd) - hEnd));
+	const float delta = 4.0 * ((fsquare(dz) - 1.0) * (k + fsquare(a)) - fsquare(a * dz));
+	const float maxThirdDerivative = 0.375 * fabsf(delta) * dqMax/(fsquare(qMin) * fastSqrtf(qMin));
+	if (maxThirdDerivative * fabsf(range) * fsquare(range) > DeltaPolynomialTolerance * 72.0 * 1.7320508)
+	{
+		return false;
+	}
+
+	mp.delta.fPolyAnchor = anchor;
+	mp.delta.fPolyC0 = f0;
+	mp.delta.fPolyC1 = (4.0 * fm - 3.0 * f0 - f1)/range;
+	mp.delta.fPolyC2 = 2.0 * (f0 - 2.0 * fm + f1)/fsquare(range);
+	return true;
+}
+
+# endif
+
 #endif // SUPPORT_LINEAR_DELTA
 
 // This is called when currentSegment has just been changed to a new segment. Return true if there is a new segment to execute.
@@ -609,6 +678,14 @@ bool DriveMovement::PrepareDeltaAxis(const DDA& dda, const PrepParams& params) n
 	isDelta = true;
 	currentSegment = (dda.shapedSegments != nullptr) ? dda.shapedSegments : dda.unshapedSegments;
 
+#if MS_USE_FPU && DM_USE_DELTA_POLYNOMIAL
+	useDeltaPolynomial = reverseStartStep > totalSteps
+						&& totalSteps >= DeltaPolynomialMinSteps
+						&& FitDeltaPolynomial(dda);
+#else
+	useDeltaPolynomial = false;
+#endif
+
 	nextStep = 0;									// must do this before calling NewDeltaSegment
 	if (!NewDeltaSegment(dda))
 	{
@@ -638,6 +715,7 @@ bool DriveMovement::PrepareExtruder(const DDA& dda, const PrepParams& params) no
 	float reverseDistance;
 
 #if MS_USE_FPU
+	bool canSmooth = false;
 	mp.cart.effectiveStepsPerMm = effStepsPerMm;
 	mp.cart.effectiveMmPerStep = effMmPerStep;
 	distanceSoFar = forwardDistance;
@@ -704,6 +782,7 @@ bool DriveMovement::PrepareExtruder(const DDA& dda, const PrepParams& params) no
 		{
 			forwardDistance += dda.totalDistance;			// no deceleration segment
 			reverseDistance = 0.0;
+			canSmooth = true;
 		}
 		else
 		{
@@ -729,6 +808,7 @@ bool DriveMovement::PrepareExtruder(const DDA& dda, const PrepParams& params) no
 					// No reversal
 					forwardDistance += dda.totalDistance - (mp.cart.pressureAdvanceK * params.unshaped.deceleration * params.unshaped.decelClocks);
 					reverseDistance = 0.0;
+					canSmooth = true;
 				}
 			}
 		}
@@ -862,7 +942,20 @@ bool DriveMovement::PrepareExtruder(const DDA& dda, const PrepParams& params) no
 		reverseStartStep = totalSteps + 1;			// no reverse phase
 	}
 
+#if MS_USE_FPU
+	// If the pressure advance is smoothed then the extruder needs its own segments. The distances we calculated above still apply.
+	if (canSmooth && shaper.GetSmoothingClocks() > 0.0)
+	{
+		ownSegments = shaper.GetSmoothedSegments(params, dda.startSpeed, dda.topSpeed);
+		if (ownSegments != nullptr)
+		{
+			mp.cart.pressureAdvanceK = mp.cart.extraExtrusionDistance = 0.0;		// the pressure advance is included in the segments
+		}
+	}
+	currentSegment = (ownSegments != nullptr) ? ownSegments : dda.unshapedSegments;
+#else
 	currentSegment = dda.unshapedSegments;
+#endif
 	isDelta = false;
 	isExtruder = true;
 
@@ -1040,12 +1133,23 @@ pre(nextStep <= totalSteps; stepsTillRecalc == 0)
 				mp.delta.fHmz0s -= steps;						// get new carriage height above Z in steps
 			}
 
-			const float hmz0sc = mp.delta.fHmz0s * dda.directionVector[Z_AXIS];
-			const float t1 = mp.delta.fMinusAaPlusBbTimesS + hmz0sc;
-			const float t2a = mp.delta.fDSquaredMinusAsquaredMinusBsquaredTimesSsquared - fsquare(mp.delta.fHmz0s) + fsquare(t1);
-			// Due to rounding error we can end up trying to take the square root of a negative number if we do not take precautions here
-			const float t2 = fastLimSqrtf(t2a);
-			const float ds = (direction) ? t1 - t2 : t1 + t2;
+			float ds;
+# if DM_USE_DELTA_POLYNOMIAL
+			if (useDeltaPolynomial)
+			{
+				const float v = mp.delta.fHmz0s - mp.delta.fPolyAnchor;
+				ds = max<float>(mp.delta.fPolyC0 + v * (mp.delta.fPolyC1 + v * mp.delta.fPolyC2), 0.0);	// the approximation may be slightly negative at the start of the move
+			}
+			else
+# endif
+			{
+				const float hmz0sc = mp.delta.fHmz0s * dda.directionVector[Z_AXIS];
+				const float t1 = mp.delta.fMinusAaPlusBbTimesS + hmz0sc;
+				const float t2a = mp.delta.fDSquaredMinusAsquaredMinusBsquaredTimesSsquared - fsquare(mp.delta.fHmz0s) + fsquare(t1);
+				// Due to rounding error we can end up trying to take the square root of a negative number if we do not take precautions here
+				const float t2 = fastLimSqrtf(t2a);
+				ds = (direction) ? t1 - t2 : t1 + t2;
+			}
 
 			// Now feed ds into the step algorithm for Cartesian motion
 			if (ds < 0.0)
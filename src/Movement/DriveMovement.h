@@ -17,6 +17,7 @@ class PrepParams;
 class ExtruderShaper;
 
 #define EVEN_STEPS			(1)						// 1 to generate steps at even intervals when doing double/quad/octal stepping
+#define DM_USE_DELTA_POLYNOMIAL	(1)					// 1 to approximate delta carriage motion by a quadratic where it is accurate enough, saving a square root per step
 
 enum class DMState : uint8_t
 {
@@ -74,6 +75,10 @@ private:
 	bool NewExtruderSegment() noexcept SPEED_CRITICAL;
 #if SUPPORT_LINEAR_DELTA
 	bool NewDeltaSegment(const DDA& dda) noexcept SPEED_CRITICAL;
+# if MS_USE_FPU && DM_USE_DELTA_POLYNOMIAL
+	bool FitDeltaPolynomial(const DDA& dda) noexcept;
+	bool CalcDeltaDistance(const DDA& dda, float hmz0s, float& ds) const noexcept;
+# endif
 #endif
 
 	static DriveMovement *freeList;
@@ -83,6 +88,7 @@ private:
 
 	DriveMovement *nextDM;								// link to next DM that needs a step
 	MoveSegment *currentSegment;
+	MoveSegment *ownSegments;							// segments that belong to this DM, used by extruders with smoothed pressure advance
 
 	DMState state;										// whether this is active or not
 	uint8_t drive;										// the drive that this DM controls
@@ -90,7 +96,8 @@ private:
 			directionChanged : 1,						// set by CalcNextStepTime if the direction is changed
 			isDelta : 1,								// true if this DM uses segment-free delta kinematics
 			isExtruder : 1,								// true if this DM is for an extruder (only matters if !isDelta)
-					: 2,								// padding to make the next field last
+			useDeltaPolynomial : 1,						// true if the delta step times in this move are calculated from the polynomial approximation
+					: 1,								// padding to make the next field last
 			stepsTakenThisSegment : 2;					// how many steps we have taken this phase, counts from 0 to 2. Last field in the byte so that we can increment it efficiently.
 	uint8_t stepsTillRecalc;							// how soon we need to recalculate
 
@@ -128,6 +135,10 @@ private:
 			float fHmz0s;								// the starting height less the starting Z height, multiplied by the Z movement fraction (can go negative)
 			float fMinusAaPlusBbTimesS;
 			float reverseStartDistance;					// the overall move distance at which movement reversal occurs
+# if DM_USE_DELTA_POLYNOMIAL
+			float fPolyAnchor;							// the value of fHmz0s at the start of the polynomial approximation
+			float fPolyC0, fPolyC1, fPolyC2;			// the coefficients of the polynomial that gives the distance moved * steps/mm in terms of (fHmz0s - fPolyAnchor)
+# endif
 #else
 			int64_t dSquaredMinusAsquaredMinusBsquaredTimesKsquaredSsquared;
 			int32_t hmz0sK;								// the starting step position less the starting Z height, multiplied by the Z movement fraction and K (can go negative)
@@ -234,6 +245,13 @@ inline int32_t DriveMovement::GetNetStepsTaken() const noexcept
 // This is inlined because it is only called from one place
 inline void DriveMovement::Release(DriveMovement *item) noexcept
 {
+	for (MoveSegment *seg = item->ownSegments; seg != nullptr; )
+	{
+		MoveSegment* const nextSeg = seg->GetNext();
+		MoveSegment::Release(seg);
+		seg = nextSeg;
+	}
+	item->ownSegments = nullptr;
 	item->nextDM = freeList;
 	freeList = item;
 }
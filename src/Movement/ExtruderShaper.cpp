@@ -13,4 +13,131 @@
 #include "DDA.h"
 #include "MoveSegment.h"
 
+#if MS_USE_FPU
+
+// Generate MoveSegments for an extruder that has pressure advance smoothed over a time window.
+// The pressure advance contribution k*a(t) to the extruder speed normally changes abruptly whenever the acceleration changes. Here we replace the acceleration a(t)
+// in that term by its average over a window centred on the current time, which turns each abrupt change into a ramp. We approximate each ramp by SmoothingSteps
+// equal steps and generate segments in which the pressure advance is already included, so the DM must use zero pressure advance with these segments.
+// The windows are shortened if necessary so that they fit within the move, so the total extrusion is the same as without smoothing.
+// The caller must have established that the extruder does not reverse during the move. Return nullptr if we can't generate the segments.
+MoveSegment *ExtruderShaper::GetSmoothedSegments(const PrepParams& params, float startSpeed, float topSpeed) const noexcept
+{
+	const PrepParams::PrepParamSet& ps = params.unshaped;
+	const float accelEndTime = ps.accelClocks;
+	const float decelStartTime = ps.accelClocks + ps.steadyClocks;
+	const float moveEndTime = decelStartTime + ps.decelClocks;
+
+	// Find the times at which the acceleration changes and how long we can make the window at each one
+	struct Window
+	{
+		float centre, halfWidth, accelBefore, accelAfter;
+	};
+	Window windows[2];
+	unsigned int numWindows = 0;
+	const float maxHalfWidth = 0.5 * smoothingClocks;
+	if (ps.accelClocks > 0.0 && ps.steadyClocks + ps.decelClocks > 0.0)
+	{
+		const float spaceAfter = (ps.steadyClocks > 0.0)
+									? ((ps.decelClocks > 0.0) ? 0.5 * ps.steadyClocks : ps.steadyClocks)
+										: ps.decelClocks;
+		windows[numWindows++] = { accelEndTime, min<float>(maxHalfWidth, min<float>(ps.accelClocks, spaceAfter)),
+									ps.acceleration, (ps.steadyClocks > 0.0) ? 0.0 : -ps.deceleration };
+	}
+	if (ps.decelClocks > 0.0 && ps.steadyClocks > 0.0)
+	{
+		const float spaceBefore = (ps.accelClocks > 0.0) ? 0.5 * ps.steadyClocks : ps.steadyClocks;
+		windows[numWindows++] = { decelStartTime, min<float>(maxHalfWidth, min<float>(spaceBefore, ps.decelClocks)), 0.0, -ps.deceleration };
+	}
+
+	// Build the list of times at which we start a new segment
+	float times[2 + 2 * (SmoothingSteps + 1)];
+	unsigned int numTimes = 0;
+	times[numTimes++] = 0.0;
+	for (unsigned int i = 0; i < numWindows; ++i)
+	{
+		const Window& w = windows[i];
+		for (unsigned int j = 0; j <= SmoothingSteps; ++j)
+		{
+			const float t = w.centre + w.halfWidth * (float)(2 * j - SmoothingSteps)/(float)SmoothingSteps;
+			if (t > times[numTimes - 1])
+			{
+				times[numTimes++] = t;
+			}
+		}
+	}
+	if (moveEndTime > times[numTimes - 1])
+	{
+		times[numTimes++] = moveEndTime;
+	}
+
+	// Generate the segments, working backwards from the end of the move because MoveSegment::Allocate adds the new segment to the front of the list
+	MoveSegment *segs = nullptr;
+	for (unsigned int i = numTimes - 1; i != 0; --i)
+	{
+		const float segStartTime = times[i - 1];
+		const float segClocks = times[i] - segStartTime;
+		const float midTime = segStartTime + 0.5 * segClocks;
+
+		// Get the actual acceleration during this segment and the speed at its start
+		float accel, speed;
+		if (midTime < accelEndTime)
+		{
+			accel = ps.acceleration;
+			speed = startSpeed + ps.acceleration * segStartTime;
+		}
+		else if (midTime < decelStartTime)
+		{
+			accel = 0.0;
+			speed = topSpeed;
+		}
+		else
+		{
+			accel = -ps.deceleration;
+			speed = topSpeed - ps.deceleration * (segStartTime - decelStartTime);
+		}
+
+		// Get the smoothed acceleration that we use for pressure advance during this segment
+		float smoothedAccel = accel;
+		for (unsigned int j = 0; j < numWindows; ++j)
+		{
+			const Window& w = windows[j];
+			if (w.halfWidth > 0.0 && fabsf(midTime - w.centre) < w.halfWidth)
+			{
+				const float stepNumber = floorf((midTime - (w.centre - w.halfWidth)) * (float)SmoothingSteps/(2.0 * w.halfWidth));
+				smoothedAccel = w.accelBefore + (w.accelAfter - w.accelBefore) * (stepNumber + 0.5)/(float)SmoothingSteps;
+				break;
+			}
+		}
+
+		const float extruderSpeed = speed + k * smoothedAccel;
+		if (extruderSpeed <= 0.0)
+		{
+			// We don't handle reversal here, so give up
+			while (segs != nullptr)
+			{
+				MoveSegment * const nextSeg = segs->GetNext();
+				MoveSegment::Release(segs);
+				segs = nextSeg;
+			}
+			return nullptr;
+		}
+
+		segs = MoveSegment::Allocate(segs);
+		const float segLength = (extruderSpeed + 0.5 * accel * segClocks) * segClocks;
+		if (accel == 0.0)
+		{
+			segs->SetLinear(segLength, segClocks, 1.0/extruderSpeed);
+		}
+		else
+		{
+			segs->SetNonLinear(segLength, segClocks, extruderSpeed/(-accel), 2.0/accel);
+		}
+	}
+
+	return segs;
+}
+
+#endif
+
 // End
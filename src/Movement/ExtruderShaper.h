@@ -12,17 +12,17 @@
 #include "MoveSegment.h"
 
 class DDA;
-class BasicPrepParams;
+struct PrepParams;
 
 // This class implements MoveSegment generation for extruders with pressure advance.
 // It also tracks extrusion that has be commanded but not implemented because less than one full step has been accumulated.
-// Currently it only supports linear pressure advance.
+// Currently it only supports linear pressure advance, optionally smoothed over a time window.
 class ExtruderShaper
 {
 public:
 	ExtruderShaper()
 #if MS_USE_FPU
-		: k(0.0),
+		: k(0.0), smoothingClocks(0.0),
 #else
 		: ik(0),
 #endif
@@ -34,6 +34,11 @@ public:
 	float GetKclocks() const noexcept { return k; }								// get pressure advance in step clocks
 	float GetKseconds() const noexcept { return k * (1.0/StepClockRate); }
 	void SetKseconds(float val) noexcept { k = val * StepClockRate; }			// set pressure advance in seconds
+	float GetSmoothingClocks() const noexcept { return smoothingClocks; }
+	float GetSmoothingSeconds() const noexcept { return smoothingClocks * (1.0/StepClockRate); }
+	void SetSmoothingSeconds(float val) noexcept { smoothingClocks = val * StepClockRate; }
+
+	MoveSegment *GetSmoothedSegments(const PrepParams& params, float startSpeed, float topSpeed) const noexcept;
 #else
 	uint32_t GetKclocks() const noexcept { return ik; }								// get pressure advance in step clocks
 	float GetKseconds() const noexcept { return (float)ik * (1.0/StepClockRate); }
@@ -41,11 +46,15 @@ public:
 #endif
 	float GetExtrusionPending() const noexcept { return extrusionPending; }
 	void SetExtrusionPending(float ep) noexcept { extrusionPending = ep; }
-#
-private:
 
+	static constexpr float MaxSmoothingSeconds = 0.2;					// the maximum pressure advance smoothing time that M572 accepts
+
+private:
 #if MS_USE_FPU
+	static constexpr unsigned int SmoothingSteps = 4;					// how many steps we use to approximate each ramp in the smoothed acceleration
+
 	float k;								// the pressure advance constant in step clocks
+	float smoothingClocks;					// the width of the window over which the pressure advance is averaged, in step clocks
 #else
 	uint32_t ik;							// the pressure advance constant in step clocks
 #endif
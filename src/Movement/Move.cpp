@@ -97,16 +97,18 @@ constexpr ObjectModelTableEntry Move::objectModelTable[] =
 	// Within each group, these entries must be in alphabetical order
 	// 0. Move members
 	{ "axes",					OBJECT_MODEL_FUNC_NOSELF(&axesArrayDescriptor), 												ObjectModelEntryFlags::live },
+	{ "axisShaping",			OBJECT_MODEL_FUNC_IF(!self->dedicatedAxisShaper.GetAxes().IsEmpty(), &self->dedicatedAxisShaper, 0),	ObjectModelEntryFlags::none },
 	{ "calibration",			OBJECT_MODEL_FUNC(self, 3),																		ObjectModelEntryFlags::none },
 	{ "compensation",			OBJECT_MODEL_FUNC(self, 6),																		ObjectModelEntryFlags::none },
 	{ "currentMove",			OBJECT_MODEL_FUNC(self, 2),																		ObjectModelEntryFlags::live },
 	{ "extruders",				OBJECT_MODEL_FUNC_NOSELF(&extrudersArrayDescriptor),											ObjectModelEntryFlags::live },
 	{ "idle",					OBJECT_MODEL_FUNC(self, 1),																		ObjectModelEntryFlags::none },
+	{ "junctionDeviation",		OBJECT_MODEL_FUNC(self->junctionDeviation, 3),													ObjectModelEntryFlags::none },
 	{ "kinematics",				OBJECT_MODEL_FUNC(self->kinematics),															ObjectModelEntryFlags::none },
 	{ "limitAxes",				OBJECT_MODEL_FUNC_NOSELF(reprap.GetGCodes().LimitAxes()),										ObjectModelEntryFlags::none },
 	{ "noMovesBeforeHoming",	OBJECT_MODEL_FUNC_NOSELF(reprap.GetGCodes().NoMovesBeforeHoming()),								ObjectModelEntryFlags::none },
 	{ "printingAcceleration",	OBJECT_MODEL_FUNC(InverseConvertAcceleration(self->maxPrintingAcceleration), 1),				ObjectModelEntryFlags::none },
-	{ "queue",					OBJECT_MODEL_FUNC_NOSELF(&queueArrayDescriptor),												ObjectModelEntryFlags::none },
+	{ "queue",					OBJECT_MODEL_FUNC_NOSELF(&queueArrayDescriptor),												ObjectModelEntryFlags::live },
 #if SUPPORT_COORDINATE_ROTATION
 	{ "rotation",				OBJECT_MODEL_FUNC(self, 44),																	ObjectModelEntryFlags::none },
 #endif
@@ -175,7 +177,7 @@ constexpr ObjectModelTableEntry Move::objectModelTable[] =
 constexpr uint8_t Move::objectModelTableDescriptor[] =
 {
 	9 + SUPPORT_COORDINATE_ROTATION,
-	17 + SUPPORT_WORKPLACE_COORDINATES,
+	19 + SUPPORT_WORKPLACE_COORDINATES,
 	2,
 	4 + SUPPORT_LASER,
 	3,
@@ -203,14 +205,14 @@ Move::Move() noexcept
 	  heightController(nullptr),
 #endif
 	  maxPrintingAcceleration(ConvertAcceleration(DefaultPrintingAcceleration)), maxTravelAcceleration(ConvertAcceleration(DefaultTravelAcceleration)),
-	  jerkPolicy(0),
+	  junctionDeviation(0.0), jerkPolicy(0),
 	  numCalibratedFactors(0)
 {
 	// Kinematics must be set up here because GCodes::Init asks the kinematics for the assumed initial position
 	kinematics = Kinematics::Create(KinematicsType::cartesian);		// default to Cartesian
-	mainDDARing.Init1(InitialDdaRingLength);
+	mainDDARing.Init1(InitialDdaRingLength, MaxAdaptiveDdaRingLength);
 #if SUPPORT_ASYNC_MOVES
-	auxDDARing.Init1(AuxDdaRingLength);
+	auxDDARing.Init1(AuxDdaRingLength, AuxDdaRingLength);
 #endif
 	DriveMovement::InitialAllocate(InitialNumDms);
 }
@@ -1017,30 +1019,152 @@ GCodeResult Move::ConfigureMovementQueue(GCodeBuffer& gb, const StringRef& reply
 	return rings[ringNumber].ConfigureMovementQueue(gb, reply);
 }
 
+// Process M593. If any axis letters are given, the command configures an input shaper dedicated to those axes. Otherwise it configures the default input shaper.
+// M593 R0 removes the axis assignment of the dedicated input shaper, so that all moves use the default one again.
+GCodeResult Move::ConfigureInputShaping(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException)
+{
+	const GCodes& gCodes = reprap.GetGCodes();
+	AxesBitmap axes;
+	for (size_t axis = 0; axis < gCodes.GetVisibleAxes(); ++axis)
+	{
+		if (gb.Seen(gCodes.GetAxisLetters()[axis]))
+		{
+			axes.SetBit(axis);
+		}
+	}
+
+	if (gb.Seen('R'))
+	{
+		(void)gb.GetLimitedUIValue('R', 1);				// only R0 is allowed
+		if (!axes.IsEmpty())
+		{
+			reply.copy("R0 cannot be combined with axis letters");
+			return GCodeResult::error;
+		}
+		if (!dedicatedAxisShaper.GetAxes().IsEmpty())
+		{
+			if (!reprap.GetGCodes().LockMovementAndWaitForStandstill(gb))
+			{
+				return GCodeResult::notFinished;
+			}
+			dedicatedAxisShaper.SetAxes(AxesBitmap());
+			reprap.MoveUpdated();
+		}
+		return GCodeResult::ok;
+	}
+
+	if (axes.IsEmpty())
+	{
+		const GCodeResult rslt = axisShaper.Configure(gb, reply);
+		if (rslt == GCodeResult::ok && !gb.SeenAny("FLSPHT") && !dedicatedAxisShaper.GetAxes().IsEmpty())
+		{
+			reply.cat('\n');
+			AppendDedicatedShaperDetails(reply);
+		}
+		return rslt;
+	}
+
+	if (axes != dedicatedAxisShaper.GetAxes())
+	{
+		if (!reprap.GetGCodes().LockMovementAndWaitForStandstill(gb))
+		{
+			return GCodeResult::notFinished;
+		}
+		dedicatedAxisShaper.SetAxes(axes);
+		reprap.MoveUpdated();
+	}
+
+	if (!gb.SeenAny("FLSPHT"))
+	{
+		AppendDedicatedShaperDetails(reply);
+		return GCodeResult::ok;
+	}
+	return dedicatedAxisShaper.Configure(gb, reply);
+}
+
+// Append the axes and the details of the dedicated input shaper to the reply
+void Move::AppendDedicatedShaperDetails(const StringRef& reply) const noexcept
+{
+	reply.cat("Axes");
+	dedicatedAxisShaper.GetAxes().Iterate([&reply](unsigned int axis, unsigned int) noexcept { reply.catf(" %c", reprap.GetGCodes().GetAxisLetters()[axis]); });
+	reply.cat(": ");
+	dedicatedAxisShaper.AppendDetails(reply);
+}
+
+// Return the input shaper to use for a move.
+// If an input shaper has been dedicated to some axes and most of the linear motion is along those axes, use that one; else use the default one.
+const AxisShaper& Move::GetAxisShaperForMove(const float directionVector[]) const noexcept
+{
+	const AxesBitmap dedicatedAxes = dedicatedAxisShaper.GetAxes();
+	if (!dedicatedAxes.IsEmpty())
+	{
+		float dedicatedMagnitudeSquared = 0.0;
+		dedicatedAxes.Iterate([&dedicatedMagnitudeSquared, directionVector](unsigned int axis, unsigned int) noexcept { dedicatedMagnitudeSquared += fsquare(directionVector[axis]); });
+		if (dedicatedMagnitudeSquared > 0.5)				// the direction vector of a move that involves linear axes has unit length over those axes
+		{
+			return dedicatedAxisShaper;
+		}
+	}
+	return axisShaper;
+}
+
 // Process M572
 GCodeResult Move::ConfigurePressureAdvance(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException)
 {
-	if (gb.Seen('S'))
+	bool seenAdvance = false, seenSmoothing = false;
+	float advance = 0.0, smoothing = 0.0;
+	gb.TryGetFValue('S', advance, seenAdvance);
+	if (gb.Seen('T'))
+	{
+		smoothing = gb.GetLimitedFValue('T', 0.0, ExtruderShaper::MaxSmoothingSeconds);
+		seenSmoothing = true;
+	}
+
+	if (seenAdvance || seenSmoothing)
 	{
-		const float advance = gb.GetFValue();
 		if (!reprap.GetGCodes().LockMovementAndWaitForStandstill(gb))
 		{
 			return GCodeResult::notFinished;
 		}
 
 		GCodeResult rslt = GCodeResult::ok;
+		bool smoothingRemote = false;
 
 #if SUPPORT_CAN_EXPANSION
 		CanDriversData<float> canDriversToUpdate;
 #endif
+		// Function to update one extruder
+		auto updateExtruder = [&](unsigned int extruder) noexcept
+								{
+									if (seenAdvance)
+									{
+										extruderShapers[extruder].SetKseconds(advance);
+									}
+									if (seenSmoothing)
+									{
+										extruderShapers[extruder].SetSmoothingSeconds(smoothing);
+									}
+#if SUPPORT_CAN_EXPANSION
+									const DriverId did = reprap.GetPlatform().GetExtruderDriver(extruder);
+									if (did.IsRemote())
+									{
+										if (seenAdvance)
+										{
+											canDriversToUpdate.AddEntry(did, advance);
+										}
+										if (seenSmoothing && smoothing > 0.0)
+										{
+											smoothingRemote = true;
+										}
+									}
+#endif
+								};
+
 		if (gb.Seen('D'))
 		{
 			uint32_t eDrive[MaxExtruders];
 			size_t eCount = MaxExtruders;
 			gb.GetUnsignedArray(eDrive, eCount, false);
-#if SUPPORT_CAN_EXPANSION
-			Platform& platform = reprap.GetPlatform();
-#endif
 			for (size_t i = 0; i < eCount; i++)
 			{
 				const uint32_t extruder = eDrive[i];
@@ -1050,14 +1174,7 @@ GCodeResult Move::ConfigurePressureAdvance(GCodeBuffer& gb, const StringRef& rep
 					rslt = GCodeResult::error;
 					break;
 				}
-				extruderShapers[extruder].SetKseconds(advance);
-#if SUPPORT_CAN_EXPANSION
-				const DriverId did = platform.GetExtruderDriver(extruder);
-				if (did.IsRemote())
-				{
-					canDriversToUpdate.AddEntry(did, advance);
-				}
-#endif
+				updateExtruder(extruder);
 			}
 		}
 		else
@@ -1070,29 +1187,19 @@ GCodeResult Move::ConfigurePressureAdvance(GCodeBuffer& gb, const StringRef& rep
 			}
 			else
 			{
-#if SUPPORT_CAN_EXPANSION
-				ct->IterateExtruders([this, advance, &canDriversToUpdate](unsigned int extruder)
-										{
-											extruderShapers[extruder].SetKseconds(advance);
-											const DriverId did = reprap.GetPlatform().GetExtruderDriver(extruder);
-											if (did.IsRemote())
-											{
-												canDriversToUpdate.AddEntry(did, advance);
-											}
-										}
-									);
-#else
-				ct->IterateExtruders([this, advance](unsigned int extruder)
-										{
-											extruderShapers[extruder].SetKseconds(advance);
-										}
-									);
-#endif
+				ct->IterateExtruders(updateExtruder);
 			}
 		}
 
 		reprap.MoveUpdated();
 
+		if (smoothingRemote && rslt == GCodeResult::ok)
+		{
+			// The CAN movement messages don't carry the smoothing time, so expansion boards apply unsmoothed pressure advance
+			reply.copy("pressure advance smoothing is not supported by extruders on expansion boards");
+			rslt = GCodeResult::warning;
+		}
+
 #if SUPPORT_CAN_EXPANSION
 		return max(rslt, CanInterface::SetRemotePressureAdvance(canDriversToUpdate, reply));
 #else
@@ -1105,6 +1212,10 @@ GCodeResult Move::ConfigurePressureAdvance(GCodeBuffer& gb, const StringRef& rep
 	for (size_t i = 0; i < reprap.GetGCodes().GetNumExtruders(); ++i)
 	{
 		reply.catf("%c %.3f", c, (double)extruderShapers[i].GetKseconds());
+		if (extruderShapers[i].GetSmoothingClocks() > 0.0)
+		{
+			reply.catf(" smoothed over %.3fs", (double)extruderShapers[i].GetSmoothingSeconds());
+		}
 		c = ',';
 	}
 	return GCodeResult::ok;
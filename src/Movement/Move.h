@@ -95,8 +95,10 @@ public:
 	GCodeResult ConfigureAccelerations(GCodeBuffer&gb, const StringRef& reply) THROWS(GCodeException);		// process M204
 	GCodeResult ConfigureMovementQueue(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException);		// process M595
 	GCodeResult ConfigurePressureAdvance(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException);	// process M572
+	GCodeResult ConfigureInputShaping(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException);		// process M593
 
 	float GetPressureAdvanceClocks(size_t extruder) const noexcept;
+	float GetPressureAdvanceSmoothingClocks(size_t extruder) const noexcept;
 
 #if SUPPORT_REMOTE_COMMANDS
 	GCodeResult EutSetRemotePressureAdvance(const CanMessageMultipleDrivesRequest<float>& msg, size_t dataLength, const StringRef& reply) noexcept;
@@ -105,6 +107,7 @@ public:
 	float GetMaxPrintingAcceleration() const noexcept { return maxPrintingAcceleration; }
 	float GetMaxTravelAcceleration() const noexcept { return maxTravelAcceleration; }
 	AxisShaper& GetAxisShaper() noexcept { return axisShaper; }
+	const AxisShaper& GetAxisShaperForMove(const float directionVector[]) const noexcept;	// Return the input shaper to use for a move
 	ExtruderShaper& GetExtruderShaper(size_t extruder) noexcept { return extruderShapers[extruder]; }
 
 	void Diagnostics(MessageType mtype) noexcept;							// Report useful stuff
@@ -133,6 +136,7 @@ public:
 
 	void Simulate(SimulationMode simMode) noexcept;											// Enter or leave simulation mode
 	float GetSimulationTime() const noexcept { return mainDDARing.GetSimulationTime(); }	// Get the accumulated simulation time
+	void AppendSimulationStats(const StringRef& reply) const noexcept { mainDDARing.AppendSimulationStats(reply); }	// Append the motion engine statistics gathered while simulating
 
 	bool PausePrint(RestorePoint& rp) noexcept;												// Pause the print as soon as we can, returning true if we were able to
 #if HAS_VOLTAGE_MONITOR || HAS_STALL_DETECT
@@ -173,6 +177,8 @@ public:
 
 	unsigned int GetJerkPolicy() const noexcept { return jerkPolicy; }
 	void SetJerkPolicy(unsigned int jp) noexcept { jerkPolicy = jp; }
+	float GetJunctionDeviation() const noexcept { return junctionDeviation; }
+	void SetJunctionDeviation(float jd) noexcept { junctionDeviation = jd; }
 
 #if HAS_SMART_DRIVERS
 	uint32_t GetStepInterval(size_t axis, uint32_t microstepShift) const noexcept;			// Get the current step interval for this axis or extruder
@@ -240,6 +246,7 @@ private:
 	float ComputeHeightCorrection(float xyzPoint[MaxAxes], const Tool *tool) const noexcept;	// Compute the height correction needed at a point, ignoring taper
 
 	const char *GetCompensationTypeString() const noexcept;
+	void AppendDedicatedShaperDetails(const StringRef& reply) const noexcept;
 
 	// Move task stack size
 	// 250 is not enough when Move and DDA debug are enabled
@@ -266,6 +273,7 @@ private:
 	float maxPrintingAcceleration;
 	float maxTravelAcceleration;
 
+	float junctionDeviation;							// Junction deviation in mm used to limit the cornering speed of the linear axes, or zero to use the per-axis jerk limits
 	unsigned int jerkPolicy;							// When we allow jerk
 	unsigned int idleCount;								// The number of times Spin was called and had no new moves to process
 
@@ -294,7 +302,8 @@ private:
 
 	Kinematics *kinematics;								// What kinematics we are using
 
-	AxisShaper axisShaper;
+	AxisShaper axisShaper;								// The default input shaper
+	AxisShaper dedicatedAxisShaper;						// The input shaper for moves that are mostly along the axes it has been dedicated to, if any
 	ExtruderShaper extruderShapers[MaxExtruders];
 
 	float latestLiveCoordinates[MaxAxesPlusExtruders];
@@ -342,6 +351,11 @@ inline float Move::GetPressureAdvanceClocks(size_t extruder) const noexcept
 	return (extruder < MaxExtruders) ? extruderShapers[extruder].GetKclocks() : 0.0;
 }
 
+inline float Move::GetPressureAdvanceSmoothingClocks(size_t extruder) const noexcept
+{
+	return (extruder < MaxExtruders) ? extruderShapers[extruder].GetSmoothingClocks() : 0.0;
+}
+
 // Get the accumulated extruder motor steps taken by an extruder since the last call. Used by the filament monitoring code.
 // Returns the number of motor steps moves since the last call, and sets isPrinting true unless we are currently executing an extruding but non-printing move
 inline int32_t Move::GetAccumulatedExtrusion(size_t drive, bool& isPrinting) noexcept
@@ -21,6 +21,7 @@ void RawMove::SetDefaults(size_t firstDriveToZero) noexcept
 	filePos = noFilePosition;
 	tool = nullptr;
 	cosXyAngle = 1.0;
+	arcSegmentRadius = 0.0;
 	for (size_t drive = firstDriveToZero; drive < MaxAxesPlusExtruders; ++drive)
 	{
 		coords[drive] = 0.0;			// clear extrusion
@@ -15,7 +15,7 @@
 #include <Platform/Platform.h>
 
 FtpResponder::FtpResponder(NetworkResponder *n) noexcept
-	: UploadingNetworkResponder(n), dataSocket(nullptr), passivePort(0), passivePortOpenTime(0), dataBuf(nullptr), haveFileToMove(false)
+	: UploadingNetworkResponder(n), dataSocket(nullptr), passivePort(0), passivePortOpenTime(0), dataBuf(nullptr), uploadAllocSize(0), haveFileToMove(false)
 {
 }
 
@@ -28,6 +28,7 @@ bool FtpResponder::Accept(Socket *s, NetworkProtocol protocol) noexcept
 		if (outBuf != nullptr || OutputBuffer::Allocate(outBuf))
 		{
 			clientPointer = 0;
+			uploadAllocSize = 0;
 			skt = s;
 			if (reprap.Debug(moduleWebserver))
 			{
@@ -157,6 +158,7 @@ void FtpResponder::Diagnostics(MessageType mt) const noexcept
 void FtpResponder::ConnectionLost() noexcept
 {
 	CloseDataPort();
+	uploadAllocSize = 0;								// an ALLO command from this session mustn't apply to the next one
 	NetworkResponder::ConnectionLost();
 }
 
@@ -284,7 +286,7 @@ void FtpResponder::SendPassiveData() noexcept
 		if (fileBuffer->IsEmpty() && fileBeingSent != nullptr)
 		{
 			const int bytesRead = fileBuffer->ReadFromFile(fileBeingSent);
-			if (bytesRead != (int)NetworkBuffer::bufferSize)
+			if (bytesRead != (int)NetworkBuffer::fileReadSize)
 			{
 				// We had a read error or we reached the end of the file
 				fileBeingSent->Close();
@@ -346,10 +348,10 @@ void FtpResponder::SendPassiveData() noexcept
 // Write some more upload data
 void FtpResponder::DoUpload() noexcept
 {
-	// Write incoming data to the file
+	// Write incoming data to the file. Several buffers may have arrived since we were last called, so write more than one of them if we can.
 	const uint8_t *buffer;
 	size_t len;
-	if (dataSocket->ReadBuffer(buffer, len))
+	for (unsigned int buffersWritten = 0; buffersWritten < MaxUploadBuffersPerSpin && dataSocket->ReadBuffer(buffer, len); ++buffersWritten)
 	{
 		if (reprap.Debug(moduleWebserver))
 		{
@@ -540,6 +542,13 @@ void FtpResponder::ProcessLine() noexcept
 			}
 			Commit(ResponderState::reading);
 		}
+		// reserve space for the next file to be stored, so that we can preallocate it
+		else if (StringStartsWith(clientMessage, "ALLO"))
+		{
+			uploadAllocSize = StrToU32(GetParameter("ALLO"));
+			outBuf->copy("200 OK.\r\n");
+			Commit(ResponderState::reading);
+		}
 		// enter passive mode mode
 		else if (StringEqualsIgnoreCase(clientMessage, "PASV"))
 		{
@@ -710,6 +719,13 @@ void FtpResponder::ProcessLine() noexcept
 			}
 			Commit(ResponderState::pasvPortOpened);
 		}
+		// reserve space for the next file to be stored, so that we can preallocate it
+		else if (StringStartsWith(clientMessage, "ALLO"))
+		{
+			uploadAllocSize = StrToU32(GetParameter("ALLO"));
+			outBuf->copy("200 OK.\r\n");
+			Commit(ResponderState::pasvPortOpened);
+		}
 		// upload a file
 		else if (StringStartsWith(clientMessage, "STOR"))
 		{
@@ -718,7 +734,9 @@ void FtpResponder::ProcessLine() noexcept
 			filenameBeingProcessed.Clear();
 
 			const char * const filename = GetParameter("STOR");
-			if (StartUpload(currentDirectory.c_str(), filename, OpenMode::write))
+			const uint32_t preAllocSize = uploadAllocSize;
+			uploadAllocSize = 0;								// an ALLO command only applies to the next STOR
+			if (StartUpload(currentDirectory.c_str(), filename, OpenMode::write, preAllocSize))
 			{
 				outBuf->copy("150 OK to send data.\r\n");
 				Commit(ResponderState::uploading);
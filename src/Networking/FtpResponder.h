@@ -43,6 +43,7 @@ protected:
 	TcpPort passivePort;
 	uint32_t passivePortOpenTime;
 	OutputBuffer *dataBuf;
+	uint32_t uploadAllocSize;							// file size from the last ALLO command, used to preallocate the next file uploaded
 
 	bool sendError;
 	bool haveCompleteLine;
@@ -24,6 +24,10 @@ static_assert(ARRAY_SIZE(serviceUnavailableResponse) <= OUTPUT_BUFFER_SIZE, "OUT
 
 const uint32_t HttpReceiveTimeout = 2000;
 
+#if SUPPORT_OBJECT_MODEL
+const unsigned int MaxHttpStreams = NumHttpResponders - 1;		// always leave one responder free for other requests
+#endif
+
 // Text for a human-readable 404 page
 const char* const ErrorPagePart1 =
 	"<html>\n"
@@ -37,6 +41,9 @@ const char* const ErrorPagePart2 =
 	"</body>\n";
 
 HttpResponder::HttpResponder(NetworkResponder *n) noexcept : UploadingNetworkResponder(n)
+#if SUPPORT_OBJECT_MODEL
+	, streamFrame(nullptr), streamSendBuf(nullptr)
+#endif
 {
 }
 
@@ -122,6 +129,11 @@ bool HttpResponder::Spin() noexcept
 		SendData();
 		return true;
 
+#if SUPPORT_OBJECT_MODEL
+	case ResponderState::streaming:
+		return SendStream();
+#endif
+
 	default:	// should not happen
 		return false;
 	}
@@ -638,7 +650,7 @@ bool HttpResponder::GetJsonResponse(const char *_ecv_array request, OutputBuffer
 		OutputBuffer::ReleaseAll(response);
 		const char *const filterVal = GetKeyValue("key");
 		const char *const flagsVal = GetKeyValue("flags");
-		response = reprap.GetModelResponse(nullptr, filterVal, flagsVal);
+		response = reprap.GetSharedModelResponse(filterVal, flagsVal);
 	}
 #endif
 	else if (StringEqualsIgnoreCase(request, "config"))
@@ -992,6 +1004,14 @@ void HttpResponder::SendJsonResponse(const char *_ecv_array command) noexcept
 			return;
 		}
 
+#if SUPPORT_OBJECT_MODEL
+		if (StringEqualsIgnoreCase(command, "stream"))			// rr_stream
+		{
+			StartStream();
+			return;
+		}
+#endif
+
 #if HAS_MASS_STORAGE
 		if (StringEqualsIgnoreCase(command, "download"))
 		{
@@ -1300,10 +1320,13 @@ void HttpResponder::RejectMessage(const char *_ecv_array response, unsigned int
 // It tries to process a chunk of uploaded data and changes the state if finished.
 void HttpResponder::DoUpload() noexcept
 {
+	// Several buffers may have arrived since we were last called, so write more than one of them if we can
 	const uint8_t *buffer;
 	size_t len;
-	if (skt->ReadBuffer(buffer, len))
+	unsigned int buffersWritten = 0;
+	while (uploadedBytes < postFileLength && buffersWritten < MaxUploadBuffersPerSpin && skt->ReadBuffer(buffer, len))
 	{
+		++buffersWritten;
 		(void)CheckAuthenticated();							// uploading may take a long time, so make sure the requester IP is not timed out
 		timer = millis();									// reset the timer
 
@@ -1320,7 +1343,8 @@ void HttpResponder::DoUpload() noexcept
 			return;
 		}
 	}
-	else if (!skt->CanRead() || millis() - timer >= HttpSessionTimeout)
+
+	if (buffersWritten == 0 && uploadedBytes < postFileLength && (!skt->CanRead() || millis() - timer >= HttpSessionTimeout))
 	{
 		// Sometimes uploads can get stuck; make sure they are cancelled when that happens
 		ConnectionLost();
@@ -1386,6 +1410,184 @@ void HttpResponder::SendData() noexcept
 	}
 }
 
+// This overrides the version in class UploadingNetworkResponder
+void HttpResponder::ConnectionLost() noexcept
+{
+#if SUPPORT_OBJECT_MODEL
+	if (responderState == ResponderState::streaming || stateAfterSending == ResponderState::streaming)
+	{
+		OutputBuffer::ReleaseAll(streamFrame);
+		streamSendBuf = nullptr;
+		stateAfterSending = ResponderState::free;
+		if (--numStreams == 0)
+		{
+			releaseSharedFrame = true;				// we may have been called from another task by Terminate(), so leave it to the Network task
+		}
+	}
+#endif
+	UploadingNetworkResponder::ConnectionLost();
+}
+
+#if SUPPORT_OBJECT_MODEL
+
+// Start pushing object model updates to the client. outBuf is non-null on entry.
+// The response is a stream of server-sent events, each holding the reply to an object model request for the changes since the previous event.
+// Parameters are 'flags' (the object model flags, as for rr_model) and 'interval' (the minimum interval between events in milliseconds).
+void HttpResponder::StartStream() noexcept
+{
+	if (numStreams >= MaxHttpStreams)
+	{
+		RejectMessage("too many streams", 503);
+		return;
+	}
+
+	const char *const flagsVal = GetKeyValue("flags");
+	streamFlags.copy((flagsVal != nullptr) ? flagsVal : "");
+	const char *const intervalVal = GetKeyValue("interval");
+	streamInterval = (intervalVal != nullptr) ? max<uint32_t>(StrToU32(intervalVal), MinStreamInterval) : DefaultStreamInterval;
+	streamSince = 0;
+
+	outBuf->copy(	"HTTP/1.1 200 OK\r\n"
+					"Cache-Control: no-cache, no-store, must-revalidate\r\n"
+					"Content-Type: text/event-stream\r\n"
+				);
+	AddCorsHeader();
+	outBuf->cat("Connection: close\r\n\r\n");
+
+	++numStreams;
+	timer = millis() - streamInterval;				// send the first event as soon as the headers have gone
+	Commit(ResponderState::streaming, false);
+	if (reprap.Debug(moduleWebserver))
+	{
+		debugPrintf("Started object model stream, interval %" PRIu32 "\n", streamInterval);
+	}
+}
+
+// Send the next object model update when it is due, returning true if we did anything significant
+bool HttpResponder::SendStream() noexcept
+{
+	if (streamFrame == nullptr)
+	{
+		if (!skt->CanSend() || !CheckAuthenticated())
+		{
+			// The client has gone away or has been logged out
+			ConnectionLost();
+			return true;
+		}
+
+		if (millis() - timer < streamInterval)
+		{
+			return false;
+		}
+
+		timer = millis();
+		streamFrame = streamSendBuf = GetStreamFrame();
+		streamSendOffset = 0;
+		if (streamFrame == nullptr)
+		{
+			ReportOutputBufferExhaustion(__FILE__, __LINE__);
+			return false;							// try again at the next interval
+		}
+	}
+
+	// Send the update. Other streams may be sending the same buffers, so keep track of how much we have sent ourselves.
+	while (streamSendBuf != nullptr)
+	{
+		const size_t bytesLeft = streamSendBuf->DataLength() - streamSendOffset;
+		if (bytesLeft != 0)
+		{
+			const size_t sent = skt->Send(reinterpret_cast<const uint8_t *>(streamSendBuf->Data() + streamSendOffset), bytesLeft);
+			if (sent == 0)
+			{
+				if (!skt->CanSend())
+				{
+					ConnectionLost();
+				}
+				return true;
+			}
+			streamSendOffset += sent;
+			if (sent < bytesLeft)
+			{
+				return true;
+			}
+		}
+		streamSendBuf = streamSendBuf->Next();
+		streamSendOffset = 0;
+	}
+
+	skt->Send();									// tell the socket there is no more data for now
+	OutputBuffer::ReleaseAll(streamFrame);
+	return true;
+}
+
+// Return the next update for this stream with a reference added for us, or nullptr if we ran out of buffers.
+// If another stream has just rendered the same update then we share it instead of rendering it again.
+OutputBuffer *HttpResponder::GetStreamFrame() noexcept
+{
+	if (releaseSharedFrame)
+	{
+		releaseSharedFrame = false;
+		OutputBuffer::ReleaseAll(sharedFrame);
+	}
+
+	if (   sharedFrame == nullptr
+		|| sharedFrameSince != streamSince
+		|| millis() - sharedFrameTime >= MinStreamInterval
+		|| !streamFlags.Equals(sharedFrameFlags.c_str())
+	   )
+	{
+		OutputBuffer::ReleaseAll(sharedFrame);
+
+		// The 'c' flag asks for only the changes since streamSince. It must come first, because RepRap::GetModelResponse looks for the first 'c'.
+		// We can't use GetSharedModelResponse because we append to the reply.
+		String<StringLength50> flags;
+		flags.printf("c%" PRIu32 ":%" PRIu32 "%s", reprap.GetChangeEpoch(), streamSince, streamFlags.c_str());
+		const uint32_t changes = reprap.GetChangeCounter();
+		OutputBuffer *reply;
+		try
+		{
+			reply = reprap.GetModelResponse(nullptr, "", flags.c_str());
+		}
+		catch (const GCodeException&)
+		{
+			reply = nullptr;
+		}
+
+		if (reply == nullptr)
+		{
+			return nullptr;
+		}
+
+		// Wrap the reply in a server-sent event. The reply already ends with a newline and has no other newlines.
+		OutputBuffer *frame;
+		if (!OutputBuffer::Allocate(frame))
+		{
+			OutputBuffer::ReleaseAll(reply);
+			return nullptr;
+		}
+		frame->copy("data: ");
+		frame->Append(reply);
+		frame->cat('\n');
+		if (frame->HadOverflow())
+		{
+			OutputBuffer::ReleaseAll(frame);
+			return nullptr;
+		}
+
+		sharedFrame = frame;
+		sharedFrameFlags.copy(streamFlags.c_str());
+		sharedFrameSince = streamSince;
+		sharedFrameChanges = changes;
+		sharedFrameTime = millis();
+	}
+
+	sharedFrame->IncreaseReferences(1);
+	streamSince = sharedFrameChanges;
+	return sharedFrame;
+}
+
+#endif
+
 void HttpResponder::Diagnostics(MessageType mt) const noexcept
 {
 	GetPlatform().MessageF(mt, " HTTP(%d)", (int)responderState);
@@ -1404,6 +1606,9 @@ void HttpResponder::Diagnostics(MessageType mt) const noexcept
 	clientsServed = 0;
 	numSessions = 0;
 	gcodeReply.ReleaseAll();
+#if SUPPORT_OBJECT_MODEL
+	releaseSharedFrame = true;						// the Network task may be using sharedFrame, so let it release it
+#endif
 }
 
 // This is called from the GCodes task to store a response, which is picked up by the Network task
@@ -1459,6 +1664,15 @@ void HttpResponder::Diagnostics(MessageType mt) const noexcept
 // Check for timed out sessions and old reply buffers
 /*static*/ void HttpResponder::CheckSessions() noexcept
 {
+#if SUPPORT_OBJECT_MODEL
+	// Release the shared stream update if another task asked us to. We do it here because this is called by the Network task.
+	if (releaseSharedFrame)
+	{
+		releaseSharedFrame = false;
+		OutputBuffer::ReleaseAll(sharedFrame);
+	}
+#endif
+
 	unsigned int clientsTimedOut = 0;
 	const uint32_t now = millis();
 	for (size_t i = numSessions; i != 0; )
@@ -1513,6 +1727,9 @@ void HttpResponder::Diagnostics(MessageType mt) const noexcept
 /*static*/ void HttpResponder::CommonDiagnostics(MessageType mtype) noexcept
 {
 	GetPlatform().MessageF(mtype, "HTTP sessions: %u of %u\n", numSessions, MaxHttpSessions);
+#if SUPPORT_OBJECT_MODEL
+	GetPlatform().MessageF(mtype, "HTTP object model streams: %u of %u\n", numStreams, MaxHttpStreams);
+#endif
 }
 
 void HttpResponder::AddCorsHeader() noexcept
@@ -1529,6 +1746,16 @@ HttpResponder::HttpSession HttpResponder::sessions[MaxHttpSessions];
 unsigned int HttpResponder::numSessions = 0;
 unsigned int HttpResponder::clientsServed = 0;
 
+#if SUPPORT_OBJECT_MODEL
+unsigned int HttpResponder::numStreams = 0;
+OutputBuffer *HttpResponder::sharedFrame = nullptr;
+String<StringLength20> HttpResponder::sharedFrameFlags;
+uint32_t HttpResponder::sharedFrameSince = 0;
+uint32_t HttpResponder::sharedFrameChanges = 0;
+uint32_t HttpResponder::sharedFrameTime = 0;
+volatile bool HttpResponder::releaseSharedFrame = false;
+#endif
+
 volatile uint16_t HttpResponder::seq = 0;
 volatile OutputStack HttpResponder::gcodeReply;
 Mutex HttpResponder::gcodeReplyMutex;
@@ -30,6 +30,7 @@ public:
 protected:
 	void CancelUpload() noexcept override;
 	void SendData() noexcept override;
+	void ConnectionLost() noexcept override;
 
 private:
 #ifdef __LPC17xx__
@@ -44,6 +45,8 @@ private:
 	static const uint32_t HttpSessionTimeout = 8000;	// HTTP session timeout in milliseconds
 	static const uint32_t MaxFileInfoGetTime = 2000;	// maximum length of time we spend getting file info, to avoid the client timing out (actual time will be a little longer than this)
 	static const uint32_t MaxBufferWaitTime = 1000;		// maximum length of time we spend waiting for a buffer before we discard gcodeReply buffers
+	static const uint32_t DefaultStreamInterval = 250;	// default interval between object model stream updates in milliseconds
+	static const uint32_t MinStreamInterval = 100;		// minimum interval between object model stream updates, also how long a rendered update may be shared
 
 	enum class HttpParseState
 	{
@@ -91,6 +94,12 @@ private:
 	bool SendFileInfo(bool quitEarly) noexcept;
 	void AddCorsHeader() noexcept;
 
+#if SUPPORT_OBJECT_MODEL
+	void StartStream() noexcept;
+	bool SendStream() noexcept;
+	OutputBuffer *GetStreamFrame() noexcept;
+#endif
+
 #if HAS_MASS_STORAGE
 	void DoUpload() noexcept;
 #endif
@@ -123,11 +132,30 @@ private:
 	time_t fileLastModified;
 	bool postFileGotCrc;
 
+#if SUPPORT_OBJECT_MODEL
+	// rr_stream requests
+	String<StringLength20> streamFlags;				// the object model flags requested by the client
+	uint32_t streamInterval;						// the minimum interval between updates
+	uint32_t streamSince;							// the change count of the last update we sent
+	OutputBuffer *streamFrame;						// the update we are sending, which may be shared with other streams
+	OutputBuffer *streamSendBuf;					// the buffer within streamFrame that we are sending
+	size_t streamSendOffset;						// how much of streamSendBuf we have sent. We can't use Taken() because the buffer may be shared.
+#endif
+
 	// Keeping track of HTTP sessions
 	static HttpSession sessions[MaxHttpSessions];
 	static unsigned int numSessions;
 	static unsigned int clientsServed;
 
+#if SUPPORT_OBJECT_MODEL
+	// The most recent object model stream update, so that streams that want the same update can share it
+	static unsigned int numStreams;
+	static OutputBuffer *sharedFrame;
+	static String<StringLength20> sharedFrameFlags;
+	static uint32_t sharedFrameSince, sharedFrameChanges, sharedFrameTime;
+	static volatile bool releaseSharedFrame;		// set to ask the Network task to release sharedFrame, because only the Network task may access it
+#endif
+
 	// Responses from GCodes class
 	static volatile uint16_t seq;					// Sequence number for G-Code replies
 	static volatile OutputStack gcodeReply;
@@ -66,7 +66,8 @@ size_t NetworkBuffer::AppendData(const uint8_t *source, size_t length) noexcept
 // Read into the buffer from a file returning the number of bytes read
 int NetworkBuffer::ReadFromFile(FileStore *f) noexcept
 {
-	const int ret = f->Read(reinterpret_cast<char*>(data32), bufferSize);
+	static_assert(fileReadSize != 0 && fileReadSize % FF_MAX_SS == 0, "fileReadSize must be a whole number of sectors");
+	const int ret = f->Read(reinterpret_cast<char*>(data32), fileReadSize);
 	dataLength = (ret > 0) ? (size_t)ret : 0;
 	readPointer = 0;
 	return ret;
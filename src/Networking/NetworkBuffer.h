@@ -93,6 +93,12 @@ public:
 	static const size_t bufferSize = 2 * 1024;
 #endif
 
+#if HAS_MASS_STORAGE
+	// When sending a file we read a whole number of 512-byte sectors into each buffer. This keeps the file position sector-aligned,
+	// so that FatFs reads the data straight from the card into data32 instead of copying it through its sector buffer.
+	static const size_t fileReadSize = bufferSize & ~(size_t)511;
+#endif
+
 private:
 	NetworkBuffer(NetworkBuffer *n) noexcept;
 	uint8_t *Data() noexcept { return reinterpret_cast<uint8_t*>(data32); }
@@ -13,7 +13,7 @@
 
 NetworkResponder::NetworkResponder(NetworkResponder *n) noexcept
 	: next(n), responderState(ResponderState::free), skt(nullptr),
-	  outBuf(nullptr),
+	  outBuf(nullptr), outBufSent(0),
 #if HAS_MASS_STORAGE
 	  fileBeingSent(nullptr),
 #endif
@@ -38,6 +38,8 @@ void NetworkResponder::Commit(ResponderState nextState, bool report) noexcept
 
 // Send our data.
 // We send outBuf first, then outStack, and finally fileBeingSent.
+// Output buffers may be shared with other responders (e.g. G-code replies and cached object model responses), so we keep track of how much we have sent
+// in outBufSent instead of calling Taken() on the buffer.
 void NetworkResponder::SendData() noexcept
 {
 	// Send our output buffer and output stack
@@ -51,14 +53,15 @@ void NetworkResponder::SendData() noexcept
 				break;
 			}
 		}
-		const size_t bytesLeft = outBuf->BytesLeft();
+		const size_t bytesLeft = outBuf->DataLength() - outBufSent;
 		if (bytesLeft == 0)
 		{
 			outBuf = OutputBuffer::Release(outBuf);
+			outBufSent = 0;
 		}
 		else
 		{
-			const size_t sent = skt->Send(reinterpret_cast<const uint8_t *>(outBuf->UnreadData()), bytesLeft);
+			const size_t sent = skt->Send(reinterpret_cast<const uint8_t *>(outBuf->Data() + outBufSent), bytesLeft);
 			if (sent == 0)
 			{
 				// Check whether the connection has been closed
@@ -74,12 +77,13 @@ void NetworkResponder::SendData() noexcept
 				return;
 			}
 
-			outBuf->Taken(sent);				// tell the output buffer how much data we have taken
+			outBufSent += sent;
 			if (sent < bytesLeft)
 			{
 				return;
 			}
 			outBuf = OutputBuffer::Release(outBuf);
+			outBufSent = 0;
 		}
 	}
 
@@ -96,13 +100,15 @@ void NetworkResponder::SendData() noexcept
 		}
 	}
 
-	// If we have a file buffer here, we must be in the process of sending a file
+	// If we have a file buffer here, we must be in the process of sending a file.
+	// Keep going while the socket accepts whole buffers, up to a limit so that other sockets still get polled.
+	unsigned int buffersSent = 0;
 	while (fileBuffer != nullptr)
 	{
 		if (fileBuffer->IsEmpty() && fileBeingSent != nullptr)
 		{
 			const int bytesRead = fileBuffer->ReadFromFile(fileBeingSent);
-			if (bytesRead != (int)NetworkBuffer::bufferSize)
+			if (bytesRead != (int)NetworkBuffer::fileReadSize)
 			{
 				// We had a read error or we reached the end of the file
 				fileBeingSent->Close();
@@ -136,8 +142,8 @@ void NetworkResponder::SendData() noexcept
 
 			fileBuffer->Taken(sent);
 
-			if (   sent < remaining				// if we couldn't send it all...
-				|| fileBuffer->IsEmpty()		// ...or if we've sent the whole buffer, return to allow other sockets to be polled
+			if (   sent < remaining													// if we couldn't send it all...
+				|| (fileBuffer->IsEmpty() && ++buffersSent == MaxFileBuffersPerSend)	// ...or if we've sent enough buffers, return to allow other sockets to be polled
 			   )
 			{
 				return;
@@ -162,6 +168,7 @@ void NetworkResponder::SendData() noexcept
 void NetworkResponder::ConnectionLost() noexcept
 {
 	OutputBuffer::ReleaseAll(outBuf);
+	outBufSent = 0;
 	outStack.ReleaseAll();
 
 #if HAS_MASS_STORAGE
@@ -44,6 +44,7 @@ protected:
 		// HTTP responder additional states
 		processingRequest,
 		gettingFileInfo,								// getting file info
+		streaming,										// pushing object model updates to the client
 
 		// FTP responder additional states
 		waitingForPasvPort,
@@ -56,6 +57,8 @@ protected:
 		authenticating
 	};
 
+	static constexpr unsigned int MaxFileBuffersPerSend = 4;	// maximum number of file buffers we send in one call to SendData
+
 	NetworkResponder(NetworkResponder *n) noexcept;
 
 	void Commit(ResponderState nextState = ResponderState::free, bool report = true) noexcept;
@@ -77,6 +80,7 @@ protected:
 
 	// Buffers for sending responses
 	OutputBuffer *outBuf;
+	size_t outBufSent;									// how much of outBuf we have sent
 	OutputStack outStack;								// not volatile because only one task accesses it
 #if HAS_MASS_STORAGE
 	FileStore *fileBeingSent;
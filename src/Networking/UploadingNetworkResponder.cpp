@@ -80,12 +80,18 @@ void UploadingNetworkResponder::FinishUpload(uint32_t fileLength, time_t fileLas
 {
 	if (!dummyUpload)
 	{
-		// Flush remaining data for FSO
+		// Flush remaining data for FSO. If we preallocated more space than we received, release the rest.
+		// This also makes the length check below meaningful, because preallocation sets the file length to the size we asked for.
 		if (!fileBeingUploaded.Flush())
 		{
 			uploadError = true;
 			GetPlatform().Message(ErrorMessage, "Could not flush remaining data while finishing upload\n");
 		}
+		else if (fileBeingUploaded.Length() > fileBeingUploaded.GetPosition() && !fileBeingUploaded.Truncate())
+		{
+			uploadError = true;
+			GetPlatform().Message(ErrorMessage, "Could not truncate file while finishing upload\n");
+		}
 
 		// Check the file length is as expected
 		if (fileLength != 0 && fileBeingUploaded.Length() != fileLength)
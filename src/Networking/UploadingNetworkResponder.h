@@ -19,6 +19,8 @@ protected:
 	virtual void CancelUpload() noexcept;
 
 #if HAS_MASS_STORAGE
+	static constexpr unsigned int MaxUploadBuffersPerSpin = 4;		// maximum number of received buffers we write to the file in one call to DoUpload
+
 	bool StartUpload(const char* folder, const char *fileName, const OpenMode mode, const uint32_t preAllocSize = 0) noexcept;
 	void FinishUpload(uint32_t fileLength, time_t fileLastModified, bool gotCrc, uint32_t expectedCrc) noexcept;
 
@@ -0,0 +1,114 @@
+/*
+ * ModelResponseCache.cpp
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include "ModelResponseCache.h"
+
+#if SUPPORT_MODEL_RESPONSE_CACHE
+
+#include <Platform/Platform.h>
+#include <Platform/RepRap.h>
+
+// An entry in the cache
+struct CachedModelResponse
+{
+	OutputBuffer *_ecv_null reply;							// the rendered response, holding one reference for the cache, or nullptr if the entry is unused
+	uint32_t changes;										// the value of the object model change counter when the response was rendered
+	uint32_t whenRendered;
+	String<StringLength100> key;
+	String<StringLength20> flags;
+};
+
+static Mutex cacheMutex;
+static CachedModelResponse entries[ModelResponseCacheEntries];
+static unsigned int numHits = 0, numMisses = 0;
+
+void ModelResponseCache::Init() noexcept
+{
+	cacheMutex.Create("ModelCache");
+	for (CachedModelResponse& e : entries)
+	{
+		e.reply = nullptr;
+	}
+}
+
+// Find a cached response to a request. If we find one, add a reference to it for the caller, who must release it when it has been sent.
+OutputBuffer *ModelResponseCache::Find(const char *_ecv_array key, const char *_ecv_array flags, uint32_t changes) noexcept
+{
+	MutexLocker lock(cacheMutex);
+	for (CachedModelResponse& e : entries)
+	{
+		if (   e.reply != nullptr
+			&& e.changes == changes
+			&& millis() - e.whenRendered < ModelResponseCacheMaxAge
+			&& e.key.Equals(key)
+			&& e.flags.Equals(flags)
+		   )
+		{
+			e.reply->IncreaseReferences(1);
+			++numHits;
+			return e.reply;
+		}
+	}
+	++numMisses;
+	return nullptr;
+}
+
+// Store a response that has just been rendered. 'changes' is the value of the change counter before rendering started.
+// The caller keeps its own reference to the response.
+void ModelResponseCache::Store(const char *_ecv_array key, const char *_ecv_array flags, uint32_t changes, OutputBuffer *reply) noexcept
+{
+	if (strlen(key) >= StringLength100 || strlen(flags) >= StringLength20)
+	{
+		return;
+	}
+
+	// Replace an entry for the same request if there is one, else an unused entry, else the oldest one
+	MutexLocker lock(cacheMutex);
+	CachedModelResponse *replace = &entries[0];
+	for (CachedModelResponse& e : entries)
+	{
+		if (e.reply == nullptr || (e.key.Equals(key) && e.flags.Equals(flags)))
+		{
+			replace = &e;
+			break;
+		}
+		if ((int32_t)(e.whenRendered - replace->whenRendered) < 0)
+		{
+			replace = &e;
+		}
+	}
+
+	OutputBuffer::ReleaseAll(replace->reply);
+	reply->IncreaseReferences(1);
+	replace->reply = reply;
+	replace->changes = changes;
+	replace->whenRendered = millis();
+	replace->key.copy(key);
+	replace->flags.copy(flags);
+}
+
+// Release any entries that are too old to be used, so that they don't tie up output buffers
+void ModelResponseCache::Expire() noexcept
+{
+	MutexLocker lock(cacheMutex);
+	for (CachedModelResponse& e : entries)
+	{
+		if (e.reply != nullptr && millis() - e.whenRendered >= ModelResponseCacheMaxAge)
+		{
+			OutputBuffer::ReleaseAll(e.reply);
+		}
+	}
+}
+
+void ModelResponseCache::Diagnostics(MessageType mtype) noexcept
+{
+	reprap.GetPlatform().MessageF(mtype, "Object model response cache hits %u, misses %u\n", numHits, numMisses);
+	numHits = numMisses = 0;
+}
+
+#endif
+
+// End
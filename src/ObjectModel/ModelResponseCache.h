@@ -0,0 +1,31 @@
+/*
+ * ModelResponseCache.h
+ *
+ *  Created on: 17 Oct 2026
+ *
+ * Short-lived cache of rendered object model responses. When several HTTP clients and the SBC ask for the same key and flags at about the same time,
+ * the first request renders the JSON and the others are given extra references to the same OutputBuffer chain instead of rendering it again.
+ * An entry is only used if the object model change counter hasn't changed since it was rendered and it is younger than ModelResponseCacheMaxAge,
+ * which limits how stale the live values in it can be. Expired entries are released from RepRap::Spin so that they don't tie up output buffers.
+ * Buffers obtained from the cache are shared, so the caller must not modify them and must not use Taken() on them.
+ */
+
+#ifndef SRC_OBJECTMODEL_MODELRESPONSECACHE_H_
+#define SRC_OBJECTMODEL_MODELRESPONSECACHE_H_
+
+#include <RepRapFirmware.h>
+
+#if SUPPORT_MODEL_RESPONSE_CACHE
+
+namespace ModelResponseCache
+{
+	void Init() noexcept;
+	OutputBuffer *_ecv_null Find(const char *_ecv_array key, const char *_ecv_array flags, uint32_t changes) noexcept;	// return a cached response with a reference added, or nullptr
+	void Store(const char *_ecv_array key, const char *_ecv_array flags, uint32_t changes, OutputBuffer *reply) noexcept;	// add a response that has just been rendered
+	void Expire() noexcept;																	// release entries that are too old to be used
+	void Diagnostics(MessageType mtype) noexcept;
+}
+
+#endif
+
+#endif /* SRC_OBJECTMODEL_MODELRESPONSECACHE_H_ */
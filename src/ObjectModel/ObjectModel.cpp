@@ -342,6 +342,13 @@ ObjectExplorationContext::ObjectExplorationContext(const GCodeBuffer *_ecv_null
 				++reportFlags;
 			}
 			break;
+		case 'c':
+			// Report changes since the specified epoch and change count. This is handled by RepRap::GetModelResponse, so just skip the numbers.
+			while (isdigit(*reportFlags) || *reportFlags == ':')
+			{
+				++reportFlags;
+			}
+			break;
 		case ' ':
 		case ',':
 			break;
@@ -18,38 +18,124 @@ Variable::~Variable()
 	val.Release();
 }
 
-Variable* VariableSet::Lookup(const char *str) noexcept
+// Calculate the hash of a variable name using the FNV-1a algorithm
+/*static*/ uint32_t VariableSet::Hash(const char *str) noexcept
+{
+	uint32_t h = 2166136261u;
+	while (*str != 0)
+	{
+		h = (h ^ (uint8_t)*str++) * 16777619u;
+	}
+	return h;
+}
+
+// Find the most recently created variable with the specified name
+VariableSet::LinkedVariable *VariableSet::Find(const char *str) const noexcept
 {
-	LinkedVariable *lv;
-	for (lv = root; lv != nullptr; lv = lv->next)
+	const uint32_t h = Hash(str);
+	if (buckets != nullptr)
 	{
-		auto vname = lv->v.GetName();
-		if (strcmp(vname.Ptr(), str) == 0)
+		for (LinkedVariable *lv = buckets[h & (NumHashBuckets - 1)]; lv != nullptr; lv = lv->nextInBucket)
 		{
-			return &(lv->v);
+			if (lv->Matches(h, str))
+			{
+				return lv;
+			}
+		}
+	}
+	else
+	{
+		for (LinkedVariable *lv = root; lv != nullptr; lv = lv->next)
+		{
+			if (lv->Matches(h, str))
+			{
+				return lv;
+			}
 		}
 	}
 	return nullptr;
 }
 
+Variable* VariableSet::Lookup(const char *str) noexcept
+{
+	LinkedVariable * const lv = Find(str);
+	return (lv == nullptr) ? nullptr : &(lv->v);
+}
+
 const Variable* VariableSet::Lookup(const char *str) const noexcept
 {
-	const LinkedVariable *lv;
-	for (lv = root; lv != nullptr; lv = lv->next)
+	const LinkedVariable * const lv = Find(str);
+	return (lv == nullptr) ? nullptr : &(lv->v);
+}
+
+void VariableSet::InsertNew(const char *str, ExpressionValue pVal, int8_t pScope) noexcept
+{
+	const uint32_t h = Hash(str);
+	LinkedVariable * const toInsert = new LinkedVariable(str, h, pVal, pScope, root);
+	root = toInsert;
+	++numVariables;
+	if (buckets != nullptr)
+	{
+		LinkedVariable *& bucket = buckets[h & (NumHashBuckets - 1)];
+		toInsert->nextInBucket = bucket;
+		bucket = toInsert;
+	}
+	else if (numVariables >= MinVariablesToHash)
+	{
+		CreateHashTable();
+	}
+}
+
+// Create the hash table and add all the existing variables to it, keeping each bucket in the same order as the main list
+void VariableSet::CreateHashTable() noexcept
+{
+	buckets = new LinkedVariable*[NumHashBuckets];
+	LinkedVariable *tails[NumHashBuckets];
+	for (size_t i = 0; i < NumHashBuckets; ++i)
 	{
-		auto vname = lv->v.GetName();
-		if (strcmp(vname.Ptr(), str) == 0)
+		buckets[i] = tails[i] = nullptr;
+	}
+
+	for (LinkedVariable *lv = root; lv != nullptr; lv = lv->next)
+	{
+		const size_t index = lv->hash & (NumHashBuckets - 1);
+		lv->nextInBucket = nullptr;
+		if (tails[index] == nullptr)
 		{
-			return &(lv->v);
+			buckets[index] = lv;
 		}
+		else
+		{
+			tails[index]->nextInBucket = lv;
+		}
+		tails[index] = lv;
 	}
-	return nullptr;
 }
 
-void VariableSet::InsertNew(const char *str, ExpressionValue pVal, int8_t pScope) noexcept
+// Unlink a variable from the main list and the hash table and delete it. 'prev' is the previous variable in the main list, or nullptr if it is the first.
+void VariableSet::Remove(LinkedVariable *prev, LinkedVariable *lv) noexcept
 {
-	LinkedVariable * const toInsert = new LinkedVariable(str, pVal, pScope, root);
-	root = toInsert;
+	if (prev == nullptr)
+	{
+		root = lv->next;
+	}
+	else
+	{
+		prev->next = lv->next;
+	}
+
+	if (buckets != nullptr)
+	{
+		LinkedVariable **pp = &buckets[lv->hash & (NumHashBuckets - 1)];
+		while (*pp != lv)
+		{
+			pp = &((*pp)->nextInBucket);
+		}
+		*pp = lv->nextInBucket;
+	}
+
+	--numVariables;
+	delete lv;
 }
 
 // Remove all variables with a scope greater than the parameter
@@ -58,45 +144,28 @@ void VariableSet::EndScope(uint8_t blockNesting) noexcept
 	LinkedVariable *prev = nullptr;
 	for (LinkedVariable *lv = root; lv != nullptr; )
 	{
+		LinkedVariable * const next = lv->next;
 		if (lv->v.GetScope() > blockNesting)
 		{
-			LinkedVariable *temp = lv;
-			lv = lv->next;
-			if (prev == nullptr)
-			{
-				root = lv;
-			}
-			else
-			{
-				prev->next = lv;
-			}
-			delete temp;
+			Remove(prev, lv);
 		}
 		else
 		{
 			prev = lv;
-			lv = lv->next;
 		}
+		lv = next;
 	}
 }
 
 void VariableSet::Delete(const char *str) noexcept
 {
+	const uint32_t h = Hash(str);
 	LinkedVariable *prev = nullptr;
 	for (LinkedVariable *lv = root; lv != nullptr; lv = lv->next)
 	{
-		auto vname = lv->v.GetName();
-		if (strcmp(vname.Ptr(), str) == 0)
+		if (lv->Matches(h, str))
 		{
-			if (prev == nullptr)
-			{
-				root = lv->next;
-			}
-			else
-			{
-				prev->next = lv->next;
-			}
-			delete lv;
+			Remove(prev, lv);
 			break;
 		}
 		prev = lv;
@@ -111,6 +180,9 @@ void VariableSet::Clear() noexcept
 		root = lv->next;
 		delete lv;
 	}
+	delete[] buckets;
+	buckets = nullptr;
+	numVariables = 0;
 }
 
 VariableSet::~VariableSet()
@@ -123,7 +195,11 @@ void VariableSet::AssignFrom(VariableSet& other) noexcept
 {
 	Clear();
 	root = other.root;
+	buckets = other.buckets;
+	numVariables = other.numVariables;
 	other.root = nullptr;
+	other.buckets = nullptr;
+	other.numVariables = 0;
 }
 
 void VariableSet::IterateWhile(function_ref<bool(unsigned int, const Variable&) /*noexcept*/ > func) const noexcept
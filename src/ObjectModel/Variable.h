@@ -33,11 +33,13 @@ private:
 };
 
 // Class to represent a collection of variables.
-// For now this is just a linked list, but it could be changed to a hash table for faster lookup and insertion.
+// The variables are kept in a linked list with the most recently created one first, which defines the order for iteration and which variable Lookup returns
+// if there are several with the same name. When the set grows beyond a few variables (typically the global variables) we also index them using a hash table,
+// in which each bucket is a chain of variables in the same order as in the main list.
 class VariableSet
 {
 public:
-	VariableSet() noexcept : root(nullptr) { }
+	VariableSet() noexcept : root(nullptr), buckets(nullptr), numVariables(0) { }
 	~VariableSet();
 	VariableSet(const VariableSet&) = delete;
 	VariableSet& operator=(const VariableSet& other) = delete;
@@ -55,17 +57,33 @@ public:
 	void IterateWhile(function_ref<bool(unsigned int index, const Variable& v) /*noexcept*/ > func) const noexcept;
 
 private:
+	static constexpr size_t NumHashBuckets = 32;				// must be a power of 2
+	static constexpr unsigned int MinVariablesToHash = 8;		// we create the hash table when the number of variables reaches this
+
 	struct LinkedVariable
 	{
 		DECLARE_FREELIST_NEW_DELETE(LinkedVariable)
 
-		LinkedVariable(const char *_ecv_array str, ExpressionValue pVal, int8_t pScope, LinkedVariable *p_next) : next(p_next), v(str, pVal, pScope) {}
+		LinkedVariable(const char *_ecv_array str, uint32_t p_hash, ExpressionValue pVal, int8_t pScope, LinkedVariable *p_next)
+			: next(p_next), nextInBucket(nullptr), hash(p_hash), v(str, pVal, pScope) {}
+
+		bool Matches(uint32_t h, const char *_ecv_array str) const noexcept { return h == hash && strcmp(v.GetName().Ptr(), str) == 0; }
 
 		LinkedVariable * null next;
+		LinkedVariable * null nextInBucket;
+		uint32_t hash;											// hash of the name, so that we seldom need to compare names
 		Variable v;
 	};
 
+	static uint32_t Hash(const char *_ecv_array str) noexcept;
+
+	LinkedVariable *null Find(const char *_ecv_array str) const noexcept;
+	void CreateHashTable() noexcept;
+	void Remove(LinkedVariable *null prev, LinkedVariable *lv) noexcept;
+
 	LinkedVariable * null root;
+	LinkedVariable * null *_ecv_array null buckets;				// hash table, or nullptr if we haven't created it
+	unsigned int numVariables;
 };
 
 #endif /* SRC_GCODES_VARIABLE_H_ */
@@ -307,6 +307,7 @@ constexpr ObjectModelTableEntry Platform::objectModelTable[] =
 #endif
 	{ "position",			OBJECT_MODEL_FUNC_NOSELF(ExpressionValue(reprap.GetMove().LiveCoordinate(ExtruderToLogicalDrive(context.GetLastIndex()), reprap.GetCurrentTool()), 1)),	ObjectModelEntryFlags::live },
 	{ "pressureAdvance",	OBJECT_MODEL_FUNC_NOSELF(reprap.GetMove().GetPressureAdvanceClocks(context.GetLastIndex())/StepClockRate, 2),							ObjectModelEntryFlags::none },
+	{ "pressureAdvanceSmoothing",	OBJECT_MODEL_FUNC_NOSELF(reprap.GetMove().GetPressureAdvanceSmoothingClocks(context.GetLastIndex())/StepClockRate, 3),		ObjectModelEntryFlags::none },
 	{ "rawPosition",		OBJECT_MODEL_FUNC_NOSELF(ExpressionValue(reprap.GetGCodes().GetRawExtruderTotalByDrive(context.GetLastIndex()), 1)), 					ObjectModelEntryFlags::live },
 	{ "speed",				OBJECT_MODEL_FUNC(InverseConvertSpeedToMmPerMin(self->MaxFeedrate(ExtruderToLogicalDrive(context.GetLastIndex()))), 1),					ObjectModelEntryFlags::none },
 	{ "stepsPerMm",			OBJECT_MODEL_FUNC(self->driveStepsPerUnit[ExtruderToLogicalDrive(context.GetLastIndex())], 2),											ObjectModelEntryFlags::none },
@@ -354,10 +355,10 @@ constexpr uint8_t Platform::objectModelTableDescriptor[] =
 #endif
 #ifdef DUET_NG	// Duet WiFi/Ethernet doesn't have settable standstill current
 	19,																		// section 3: move.axes[]
-	14,																		// section 4: move.extruders[]
+	15,																		// section 4: move.extruders[]
 #else
 	20,																		// section 3: move.axes[]
-	15,																		// section 4: move.extruders[]
+	16,																		// section 4: move.extruders[]
 #endif
 	3,																		// section 5: move.extruders[].nonlinear
 #if HAS_12V_MONITOR
@@ -4033,6 +4034,15 @@ FileStore* Platform::OpenSysFile(const char *_ecv_array filename, OpenMode mode)
 				: nullptr;
 }
 
+// Open a macro file for reading, using the macro cache if possible
+FileStore* Platform::OpenSysMacroFile(const char *_ecv_array filename) const noexcept
+{
+	String<MaxFilenameLength> location;
+	return (MakeSysFileName(location.GetRef(), filename))
+			? MassStorage::OpenMacroFile(location.c_str())
+				: nullptr;
+}
+
 bool Platform::MakeSysFileName(const StringRef& result, const char *_ecv_array filename) const noexcept
 {
 	return MassStorage::CombineName(result, GetSysDir().Ptr(), filename);
@@ -425,6 +425,7 @@ public:
 	GCodeResult SetSysDir(const char *_ecv_array dir, const StringRef& reply) noexcept;				// Set the system files path
 	bool SysFileExists(const char *_ecv_array filename) const noexcept;
 	FileStore* OpenSysFile(const char *_ecv_array filename, OpenMode mode) const noexcept;
+	FileStore* OpenSysMacroFile(const char *_ecv_array filename) const noexcept;
 # if HAS_MASS_STORAGE || HAS_SBC_INTERFACE
 	bool DeleteSysFile(const char *_ecv_array filename) const noexcept;
 # endif
@@ -22,6 +22,7 @@
 #include <Hardware/SoftwareReset.h>
 #include <Hardware/ExceptionHandlers.h>
 #include <Accelerometers/Accelerometers.h>
+#include <ObjectModel/ModelResponseCache.h>
 #include "Version.h"
 
 #ifdef DUET_NG
@@ -427,6 +428,7 @@ ReadWriteLock RepRap::toolListLock;
 RepRap::RepRap() noexcept
 	: boardsSeq(0), directoriesSeq(0), fansSeq(0), heatSeq(0), inputsSeq(0), jobSeq(0), moveSeq(0), globalSeq(0),
 	  networkSeq(0), scannerSeq(0), sensorsSeq(0), spindlesSeq(0), stateSeq(0), toolsSeq(0), volumesSeq(0),
+	  changeCounter(1), changeEpoch(0), changeStamps{},
 	  toolList(nullptr), currentTool(nullptr), lastWarningMillis(0),
 	  activeExtruders(0), activeToolHeaters(0), numToolsToReport(0),
 	  ticksInSpinState(0), heatTaskIdleTicks(0),
@@ -508,6 +510,9 @@ void RepRap::Init() noexcept
 #endif
 
 	messageBoxMutex.Create("MessageBox");
+#if SUPPORT_MODEL_RESPONSE_CACHE
+	ModelResponseCache::Init();
+#endif
 
 	platform->Init();
 	network->Init();
@@ -670,6 +675,14 @@ void RepRap::Init() noexcept
 	}
 	processingConfig = false;
 
+	// Choose the change epoch for this boot. The time taken to run config.g varies from one boot to the next, so the step clock gives us a value
+	// that a client is most unlikely to have been given by a previous boot. A client that asked for changes during configuration was given epoch 0.
+	changeEpoch = StepTimer::GetTimerTicks() ^ (millis() << 16);
+	if (changeEpoch == 0)
+	{
+		changeEpoch = 1;
+	}
+
 #if HAS_HIGH_SPEED_SD && !SAME5x
 	hsmci_set_idle_func(hsmciIdle);
 	HSMCI->HSMCI_IDR = 0xFFFFFFFF;						// disable all HSMCI interrupts
@@ -785,6 +798,10 @@ void RepRap::Spin() noexcept
 	ticksInSpinState = 0;
 	spinningModule = noModule;
 
+#if SUPPORT_MODEL_RESPONSE_CACHE
+	ModelResponseCache::Expire();
+#endif
+
 	// Check if we need to send diagnostics
 	if (diagnosticsDestination != MessageType::NoDestinationMessage)
 	{
@@ -938,6 +955,9 @@ void RepRap::Diagnostics(MessageType mtype) noexcept
 	heat->Diagnostics(mtype);
 	gCodes->Diagnostics(mtype);
 	FilamentMonitor::Diagnostics(mtype);
+#if SUPPORT_MODEL_RESPONSE_CACHE
+	ModelResponseCache::Diagnostics(mtype);
+#endif
 #ifdef DUET_NG
 	DuetExpansion::Diagnostics(mtype);
 #endif
@@ -2540,7 +2560,31 @@ OutputBuffer *RepRap::GetModelResponse(const GCodeBuffer *_ecv_null gb, const ch
 		if (key == nullptr) { key = ""; }
 		if (flags == nullptr) { flags = ""; }
 
-		outBuf->printf("{\"key\":\"%.s\",\"flags\":\"%.s\",\"result\":", key, flags);
+		// If the flags include 'c' followed by an epoch, a colon and a change count and the whole model was requested, the client only wants the parts
+		// that have changed since then. 'c' followed by anything else asks for the whole model and the current epoch and change count.
+		const char *_ecv_array const sinceFlag = (*key == 0) ? strchr(flags, 'c') : nullptr;
+		uint32_t since = 0;
+		if (sinceFlag != nullptr)
+		{
+			const char *_ecv_array sinceEnd;
+			const uint32_t epoch = StrToU32(sinceFlag + 1, &sinceEnd);
+			if (*sinceEnd == ':' && epoch == changeEpoch)
+			{
+				since = StrToU32(sinceEnd + 1);		// if the epoch differs then the client got 'since' from an earlier boot, so it needs a full report
+			}
+		}
+		const uint32_t changes = changeCounter;			// read this before we start reporting, so that we err on the side of reporting changes twice
+		if (since > changes)
+		{
+			since = 0;									// the client didn't get 'since' from us, so it needs a full report
+		}
+
+		outBuf->printf("{\"key\":\"%.s\",\"flags\":\"%.s\",", key, flags);
+		if (sinceFlag != nullptr)
+		{
+			outBuf->catf("\"changes\":\"%" PRIu32 ":%" PRIu32 "\",", changeEpoch, changes);
+		}
+		outBuf->cat("\"result\":");
 
 		const bool wantArrayLength = (*key == '#');
 		if (wantArrayLength)
@@ -2550,7 +2594,14 @@ OutputBuffer *RepRap::GetModelResponse(const GCodeBuffer *_ecv_null gb, const ch
 
 		try
 		{
-			reprap.ReportAsJson(gb, outBuf, key, flags, wantArrayLength);
+			if (sinceFlag != nullptr)
+			{
+				ReportModelChanges(gb, outBuf, flags, since);
+			}
+			else
+			{
+				reprap.ReportAsJson(gb, outBuf, key, flags, wantArrayLength);
+			}
 			outBuf->cat("}\n");
 			if (outBuf->HadOverflow())
 			{
@@ -2567,6 +2618,76 @@ OutputBuffer *RepRap::GetModelResponse(const GCodeBuffer *_ecv_null gb, const ch
 	return outBuf;
 }
 
+// Return a query into the object model for a client that doesn't need a GCodeBuffer context, or nullptr if no buffer is available.
+// If another client has just made the same request and nothing has changed since, the same buffers are returned with an extra reference,
+// so the caller must not modify them and must not use Taken() on them.
+OutputBuffer *RepRap::GetSharedModelResponse(const char *key, const char *flags) const THROWS(GCodeException)
+{
+#if SUPPORT_MODEL_RESPONSE_CACHE
+	if (key == nullptr) { key = ""; }
+	if (flags == nullptr) { flags = ""; }
+
+	const uint32_t changes = changeCounter;				// read this before rendering, so that a change made while we render invalidates the entry
+	OutputBuffer *outBuf = ModelResponseCache::Find(key, flags, changes);
+	if (outBuf == nullptr)
+	{
+		outBuf = GetModelResponse(nullptr, key, flags);
+		if (outBuf != nullptr)
+		{
+			ModelResponseCache::Store(key, flags, changes, outBuf);
+		}
+	}
+	return outBuf;
+#else
+	return GetModelResponse(nullptr, key, flags);
+#endif
+}
+
+// Names of the object model subtrees that have their own sequence numbers, in the same order as enum ModelSubtree
+static constexpr const char *_ecv_array ModelSubtreeNames[] =
+{
+	"boards", "directories", "fans", "global", "heat", "inputs", "job", "move", "network", "scanner", "sensors", "spindles", "state", "tools", "volumes"
+};
+
+// Return the value of the change counter when the top-level object model key 'key' was last changed, or 0 if it doesn't have a sequence number
+uint32_t RepRap::GetChangeStamp(const char *_ecv_array key) const noexcept
+{
+	static_assert(ARRAY_SIZE(ModelSubtreeNames) == (size_t)ModelSubtree::numSubtrees, "ModelSubtreeNames doesn't match enum ModelSubtree");
+	for (size_t i = 0; i < ARRAY_SIZE(ModelSubtreeNames); ++i)
+	{
+		if (strcmp(key, ModelSubtreeNames[i]) == 0)
+		{
+			return changeStamps[i];
+		}
+	}
+	return 0;
+}
+
+// Report the root of the object model, but only include the non-live parts of subtrees that have changed since the change counter had the value 'since'.
+// Subtrees that haven't changed are reported as if the 'f' flag had been given, or omitted if they have no live values.
+// If 'since' is zero then we report everything, so that a client can get the whole model and the change counter in one request.
+void RepRap::ReportModelChanges(const GCodeBuffer *_ecv_null gb, OutputBuffer *buf, const char *_ecv_array flags, uint32_t since) const THROWS(GCodeException)
+{
+	String<StringLength50> liveFlags;
+	liveFlags.copy("f");
+	liveFlags.cat(flags);
+
+	bool added = false;
+	const size_t numEntries = objectModelTableDescriptor[1];
+	for (size_t i = 0; i < numEntries; ++i)
+	{
+		const ObjectModelTableEntry& entry = objectModelTable[i];
+		const bool changed = since == 0 || GetChangeStamp(entry.name) > since;
+		if (changed || ((uint8_t)entry.flags & (uint8_t)ObjectModelEntryFlags::live) != 0)
+		{
+			buf->catf((added) ? ",\"%s\":" : "{\"%s\":", entry.name);
+			reprap.ReportAsJson(gb, buf, entry.name, (changed) ? flags : liveFlags.c_str(), false);
+			added = true;
+		}
+	}
+	buf->cat((added) ? "}" : "{}");
+}
+
 #endif
 
 // Send a beep. We send it to both PanelDue and the web interface.
@@ -155,6 +155,7 @@ public:
 
 #if SUPPORT_OBJECT_MODEL
 	OutputBuffer *GetModelResponse(const GCodeBuffer *_ecv_null gb, const char *key, const char *flags) const THROWS(GCodeException);
+	OutputBuffer *GetSharedModelResponse(const char *key, const char *flags) const THROWS(GCodeException);
 #endif
 
 	void Beep(unsigned int freq, unsigned int ms) noexcept;
@@ -184,21 +185,23 @@ public:
 
 	void KickHeatTaskWatchdog() noexcept { heatTaskIdleTicks = 0; }
 
-	void BoardsUpdated() noexcept { ++boardsSeq; }
-	void DirectoriesUpdated() noexcept { ++directoriesSeq; }
-	void FansUpdated() noexcept { ++fansSeq; }
-	void GlobalUpdated() noexcept { ++globalSeq; }
-	void HeatUpdated() noexcept { ++heatSeq; }
-	void InputsUpdated() noexcept { ++inputsSeq; }
-	void JobUpdated() noexcept { ++jobSeq; }
-	void MoveUpdated() noexcept { ++moveSeq; }
-	void NetworkUpdated() noexcept { ++networkSeq; }
-	void ScannerUpdated() noexcept { ++scannerSeq; }
-	void SensorsUpdated() noexcept { ++sensorsSeq; }
-	void SpindlesUpdated() noexcept { ++spindlesSeq; }
-	void StateUpdated() noexcept { ++stateSeq; }
-	void ToolsUpdated() noexcept { ++toolsSeq; }
-	void VolumesUpdated() noexcept { ++volumesSeq; }
+	void BoardsUpdated() noexcept { ++boardsSeq; NoteChange(ModelSubtree::boards); }
+	void DirectoriesUpdated() noexcept { ++directoriesSeq; NoteChange(ModelSubtree::directories); }
+	void FansUpdated() noexcept { ++fansSeq; NoteChange(ModelSubtree::fans); }
+	void GlobalUpdated() noexcept { ++globalSeq; NoteChange(ModelSubtree::global); }
+	void HeatUpdated() noexcept { ++heatSeq; NoteChange(ModelSubtree::heat); }
+	void InputsUpdated() noexcept { ++inputsSeq; NoteChange(ModelSubtree::inputs); }
+	void JobUpdated() noexcept { ++jobSeq; NoteChange(ModelSubtree::job); }
+	void MoveUpdated() noexcept { ++moveSeq; NoteChange(ModelSubtree::move); }
+	void NetworkUpdated() noexcept { ++networkSeq; NoteChange(ModelSubtree::network); }
+	void ScannerUpdated() noexcept { ++scannerSeq; NoteChange(ModelSubtree::scanner); }
+	void SensorsUpdated() noexcept { ++sensorsSeq; NoteChange(ModelSubtree::sensors); }
+	void SpindlesUpdated() noexcept { ++spindlesSeq; NoteChange(ModelSubtree::spindles); }
+	void StateUpdated() noexcept { ++stateSeq; NoteChange(ModelSubtree::state); }
+	void ToolsUpdated() noexcept { ++toolsSeq; NoteChange(ModelSubtree::tools); }
+	void VolumesUpdated() noexcept { ++volumesSeq; NoteChange(ModelSubtree::volumes); }
+	uint32_t GetChangeCounter() const noexcept { return changeCounter; }
+	uint32_t GetChangeEpoch() const noexcept { return changeEpoch; }
 
 	ReadLockedPointer<const VariableSet> GetGlobalVariablesForReading() noexcept { return globalVariables.GetForReading(); }
 	WriteLockedPointer<VariableSet> GetGlobalVariablesForWriting() noexcept { return globalVariables.GetForWriting(); }
@@ -227,6 +230,26 @@ private:
 	void ReportToolTemperatures(const StringRef& reply, const Tool *tool, bool includeNumber) const noexcept;
 	bool RunStartupFile(const char *filename) noexcept;
 
+	// Subtrees of the object model that have their own sequence numbers, in the same order as the names in RepRap.cpp
+	enum class ModelSubtree : uint8_t
+	{
+		boards = 0, directories, fans, global, heat, inputs, job, move, network, scanner, sensors, spindles, state, tools, volumes,
+		numSubtrees
+	};
+
+	// Record that a subtree has changed. The counter and the stamp are updated with interrupts disabled, so that a higher priority task can't see
+	// the new counter value before the stamp has been stored, and two tasks noting changes at the same time can't both get the same stamp.
+	void NoteChange(ModelSubtree s) noexcept
+	{
+		AtomicCriticalSectionLocker lock;
+		changeStamps[(unsigned int)s] = ++changeCounter;
+	}
+
+#if SUPPORT_OBJECT_MODEL
+	uint32_t GetChangeStamp(const char *_ecv_array key) const noexcept;
+	void ReportModelChanges(const GCodeBuffer *_ecv_null gb, OutputBuffer *buf, const char *_ecv_array flags, uint32_t since) const THROWS(GCodeException);
+#endif
+
 	static constexpr uint32_t MaxTicksInSpinState = 20000;	// timeout before we reset the processor
 	static constexpr uint32_t HighTicksInSpinState = 16000;	// how long before we warn that timeout is approaching
 
@@ -266,6 +289,10 @@ private:
 	uint16_t boardsSeq, directoriesSeq, fansSeq, heatSeq, inputsSeq, jobSeq, moveSeq, globalSeq;
 	uint16_t networkSeq, scannerSeq, sensorsSeq, spindlesSeq, stateSeq, toolsSeq, volumesSeq;
 
+	volatile uint32_t changeCounter;			// incremented whenever any of the above sequence numbers changes
+	uint32_t changeEpoch;						// chosen at the end of startup, so that clients can tell whether a change count came from this boot
+	uint32_t changeStamps[(unsigned int)ModelSubtree::numSubtrees];	// the value of changeCounter when each subtree last changed
+
 	GlobalVariables globalVariables;
 
 	Tool* toolList;								// the tool list is sorted in order of increasing tool number
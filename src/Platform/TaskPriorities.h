@@ -13,6 +13,7 @@ namespace TaskPriority
 {
 	constexpr unsigned int IdlePriority = 0;
 	constexpr unsigned int SpinPriority = 1;						// priority for tasks that rarely block
+	constexpr unsigned int FilePrefetchPriority = 1;				// same as the main task, which rarely blocks, so that the prefetch task gets to run while it is waiting for the card
 #if HAS_SBC_INTERFACE
 	constexpr unsigned int SbcPriority = 2;							// priority for SBC task
 #endif
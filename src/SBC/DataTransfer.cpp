@@ -993,10 +993,10 @@ bool DataTransfer::WriteObjectModel(OutputBuffer *data) noexcept
 	header->length = data->Length();
 	header->padding = 0;
 
-	// Write data
+	// Write data. The buffers may be shared with other clients, so ignore any record of how much has been read from them.
 	while (data != nullptr)
 	{
-		WriteData(data->UnreadData(), data->BytesLeft());
+		WriteData(data->Data(), data->DataLength());
 		data = OutputBuffer::Release(data);
 	}
 	return true;
@@ -0,0 +1,105 @@
+/*
+ * FileInfoCache.cpp
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include "FileInfoCache.h"
+
+#if SUPPORT_FILE_INFO_CACHE
+
+#include "MassStorage.h"
+#include <Platform/Platform.h>
+#include <Platform/RepRap.h>
+
+// Return the offset in the cache file of the record for a file. Paths are hashed using the FNV-1a algorithm, ignoring case because FAT filenames are not case-sensitive.
+/*static*/ FilePosition FileInfoCache::SlotOffset(const char *_ecv_array filePath) noexcept
+{
+	uint32_t h = 2166136261u;
+	while (*filePath != 0)
+	{
+		h = (h ^ (uint8_t)tolower(*filePath++)) * 16777619u;
+	}
+	return (FilePosition)(h % FileInfoCacheSlots) * sizeof(Record);
+}
+
+// Look up a file in the cache. If we have a record for it and the file hasn't changed since, copy the information to 'info' and return true.
+bool FileInfoCache::Find(const char *_ecv_array filePath, GCodeFileInfo& info) noexcept
+{
+	FilePosition fileSize;
+	time_t lastModifiedTime;
+	if (!MassStorage::GetFileSizeAndModifiedTime(filePath, fileSize, lastModifiedTime))
+	{
+		return false;
+	}
+
+	if (!reprap.GetPlatform().MakeSysFileName(cacheFilePath.GetRef(), FILE_INFO_CACHE_FILE))
+	{
+		return false;
+	}
+
+	bool found = false;
+	FileStore * const f = MassStorage::OpenFile(cacheFilePath.c_str(), OpenMode::read, 0);
+	if (f != nullptr)
+	{
+		found = f->Seek(SlotOffset(filePath))
+				&& f->Read(reinterpret_cast<char *_ecv_array>(&record), sizeof(record)) == (int)sizeof(record)
+				&& record.signature == RecordSignature
+				&& record.version == FormatVersion
+				&& record.recordSize == sizeof(Record)
+				&& record.fileSize == fileSize
+				&& record.lastModifiedTime == lastModifiedTime
+				&& StringEqualsIgnoreCase(record.path, filePath);
+		f->Close();
+	}
+
+	if (found)
+	{
+		info = record.info;
+		++numHits;
+	}
+	else
+	{
+		++numMisses;
+	}
+	return found;
+}
+
+// Store the information about a file that has just been parsed. Failure to write the cache file isn't an error, so we don't report it.
+void FileInfoCache::Store(const char *_ecv_array filePath, const GCodeFileInfo& info) noexcept
+{
+	if (strlen(filePath) >= MaxFilenameLength || !reprap.GetPlatform().MakeSysFileName(cacheFilePath.GetRef(), FILE_INFO_CACHE_FILE))
+	{
+		return;
+	}
+
+	record.signature = RecordSignature;
+	record.version = FormatVersion;
+	record.recordSize = sizeof(Record);
+	record.fileSize = info.fileSize;
+	record.lastModifiedTime = info.lastModifiedTime;
+	SafeStrncpy(record.path, filePath, sizeof(record.path));
+	record.info = info;
+
+	// Append mode lets us overwrite a record in the middle of the file without truncating it. Seeking beyond the end of the file extends it.
+	// The cache file is never run as a macro, so writing it mustn't invalidate the macro cache.
+	FileStore * const f = MassStorage::OpenFile(cacheFilePath.c_str(), OpenMode::append, 0, true);
+	if (f != nullptr)
+	{
+		if (f->Seek(SlotOffset(filePath)))
+		{
+			(void)f->Write(reinterpret_cast<const char *_ecv_array>(&record), sizeof(record));
+		}
+		f->Close();
+	}
+}
+
+void FileInfoCache::Diagnostics(MessageType mtype) noexcept
+{
+	reprap.GetPlatform().MessageF(mtype, "File info cache hits %u, misses %u\n", numHits, numMisses);
+	numHits = numMisses = 0;
+}
+
+#endif
+
+// End
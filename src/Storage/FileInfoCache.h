@@ -0,0 +1,56 @@
+/*
+ * FileInfoCache.h
+ *
+ *  Created on: 17 Oct 2026
+ *
+ * Persistent cache of the results of parsing G-code files, so that repeated file info requests don't need to read the G-code file again.
+ * The cache is a file in the system directory holding FileInfoCacheSlots fixed-size records. The slot for a file is chosen by hashing its path,
+ * so a lookup needs just one seek and one read. Each record holds the path, size and last modified time of the file it describes,
+ * so a record is ignored if the file has been replaced or changed since it was parsed, for example by uploading a new version.
+ * If two files hash to the same slot then the most recently parsed one wins.
+ */
+
+#ifndef SRC_STORAGE_FILEINFOCACHE_H_
+#define SRC_STORAGE_FILEINFOCACHE_H_
+
+#include <RepRapFirmware.h>
+
+#if SUPPORT_FILE_INFO_CACHE
+
+#include <GCodes/GCodeFileInfo.h>
+
+// This class is not thread-safe. It is only used by FileInfoParser, which holds its own mutex while calling it.
+class FileInfoCache
+{
+public:
+	FileInfoCache() noexcept : numHits(0), numMisses(0) { }
+
+	bool Find(const char *_ecv_array filePath, GCodeFileInfo& info) noexcept;			// look up a file, returning true and setting up info if it is in the cache
+	void Store(const char *_ecv_array filePath, const GCodeFileInfo& info) noexcept;	// add the results of parsing a file to the cache
+	void Diagnostics(MessageType mtype) noexcept;
+
+private:
+	static constexpr uint32_t RecordSignature = 0x43494652;		// "RFIC"
+	static constexpr uint16_t FormatVersion = 2;				// increment this if the way that files are parsed changes, to discard existing records
+
+	struct Record
+	{
+		uint32_t signature;
+		uint16_t version;
+		uint16_t recordSize;
+		FilePosition fileSize;
+		time_t lastModifiedTime;
+		char path[MaxFilenameLength];
+		GCodeFileInfo info;
+	};
+
+	static FilePosition SlotOffset(const char *_ecv_array filePath) noexcept;
+
+	Record record;												// kept here rather than on the stack because it is quite large
+	String<MaxFilenameLength> cacheFilePath;					// path of the cache file in the system directory, also kept here to save stack
+	unsigned int numHits, numMisses;
+};
+
+#endif
+
+#endif /* SRC_STORAGE_FILEINFOCACHE_H_ */
@@ -0,0 +1,189 @@
+/*
+ * FileInfoMatcher.cpp
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include "FileInfoMatcher.h"
+
+#if HAS_MASS_STORAGE || HAS_EMBEDDED_FILES
+
+#include "FileInfoParser.h"
+
+static_assert(GCODE_READ_SIZE + GCODE_OVERLAP_SIZE <= 65535, "Match offsets must fit in uint16_t");
+
+// The key strings, in the same order as enum FileInfoMatcher::Key. Each one must be at least 2 characters long.
+static constexpr const char *_ecv_array KeyStrings[] =
+{
+	// Layer height
+	"layer_height",				// slic3r
+	"Layer height",				// Cura
+	"layerHeight",				// S3D
+	"layer_thickness_mm",		// Kisslicer
+	"layerThickness",			// Matter Control
+	"sliceHeight",				// kiri:moto
+
+	// Number of layers
+	"num_layers",
+	"NUM_LAYERS",
+
+	// Slicer name
+	"; KISSlicer",				// KISSlicer
+	";Sliced at: ",				// Cura (old)
+	";Fusion version:",			// Fusion 360
+	"generated by ",			// slic3r and S3D
+	";Sliced by ",				// ideaMaker
+	";Generated with ",			// Cura (new)
+	"; Generated by ",			// kiri:moto
+	";GENERATOR.NAME:",			// Pathio (the version is separate, we don't include that)
+	"; Generated with ",		// Matter Control
+
+	// Print time. Note: if a string here is a leading or embedded substring of another, the longer one must come first
+	" estimated printing time (normal mode)",	// slic3r PE later versions			"; estimated printing time (normal mode) = 2d 1h 5m 24s"
+	" estimated printing time",					// slic3r PE older versions			"; estimated printing time = 1h 5m 24s"
+	";TIME",									// Cura								";TIME:38846"
+	" Build time",								// S3D								";   Build time: 0 hours 42 minutes"
+												// also REALvision					"; Build time: 2:11:47"
+	" Build Time",								// KISSlicer						"; Estimated Build Time:   332.83 minutes"
+												// also KISSSlicer 2 alpha			"; Calculated-during-export Build Time: 130.62 minutes"
+	";Print Time:",								// Ideamaker
+	";PRINT.TIME:",								// Patio
+	";Print time:",								// Fusion 360
+	"; total print time (s) =",					// Matter Control
+
+	// Simulated print time
+	FileInfoParser::SimulatedTimeString,
+
+	// Filament used
+	"ilament used",								// slic3r and Cura, followed by filament used and "mm"
+	";Material#",								// Ideamaker, e.g. ";Material#1 Used: 868.0"
+	";Extruder ",								// Fusion 360, e.g. ";Extruder 1 material used: 1811mm"
+	"ilament length",							// S3D
+	";    Ext ",								// recent KISSlicer versions
+	"; Estimated Build Volume: ",				// old KISSlicer
+	";EXTRUDER_TRAIN.0.MATERIAL.VOLUME_USED:",	// Pathio
+
+	// Thumbnails
+	"; thumbnail",
+};
+
+static_assert(ARRAY_SIZE(KeyStrings) == FileInfoMatcher::NumKeys, "KeyStrings doesn't match enum Key");
+
+// Hash function for the first two characters of a key. The constants were chosen so that pairs of characters that are common in G-code,
+// such as a digit followed by a space or newline, seldom hash to the same value as the first two characters of any key.
+static constexpr uint8_t PairHash(char c0, char c1) noexcept
+{
+	return (uint8_t)(((uint8_t)c0 * 26u) ^ ((uint8_t)c1 << 2) ^ ((uint8_t)c1 >> 6));
+}
+
+// Table of the keys that may start with each pair of characters, indexed by PairHash
+struct PairTable
+{
+	uint64_t keysStartingWith[256];
+};
+
+static constexpr PairTable MakePairTable() noexcept
+{
+	PairTable table = {};
+	for (unsigned int i = 0; i < FileInfoMatcher::NumKeys; ++i)
+	{
+		table.keysStartingWith[PairHash(KeyStrings[i][0], KeyStrings[i][1])] |= (uint64_t)1 << i;
+	}
+	return table;
+}
+
+static constexpr PairTable pairTable = MakePairTable();
+
+// Table of key lengths
+struct LengthTable
+{
+	uint8_t lengths[FileInfoMatcher::NumKeys];
+};
+
+static constexpr LengthTable MakeLengthTable() noexcept
+{
+	LengthTable table = {};
+	for (unsigned int i = 0; i < FileInfoMatcher::NumKeys; ++i)
+	{
+		size_t len = 0;
+		while (KeyStrings[i][len] != 0)
+		{
+			++len;
+		}
+		table.lengths[i] = (uint8_t)len;
+	}
+	return table;
+}
+
+static constexpr LengthTable lengthTable = MakeLengthTable();
+
+/*static*/ const char *_ecv_array FileInfoMatcher::GetKeyString(Key k) noexcept
+{
+	return KeyStrings[(unsigned int)k];
+}
+
+/*static*/ size_t FileInfoMatcher::GetKeyLength(Key k) noexcept
+{
+	return lengthTable.lengths[(unsigned int)k];
+}
+
+// Find all occurrences of all the keys in a null-terminated buffer of length 'len'
+void FileInfoMatcher::Scan(const char *_ecv_array buf, size_t len) noexcept
+{
+	bufferStart = buf;
+	for (KeyMatches& m : matches)
+	{
+		m.count = 0;
+		m.overflowed = false;
+	}
+
+	for (size_t offset = 0; offset + 1 < len; ++offset)
+	{
+		uint64_t candidates = pairTable.keysStartingWith[PairHash(buf[offset], buf[offset + 1])];
+		while (candidates != 0)
+		{
+			const unsigned int i = (unsigned int)__builtin_ctzll(candidates);
+			candidates &= candidates - 1;
+			const size_t keyLength = lengthTable.lengths[i];
+			if (offset + keyLength <= len && memcmp(buf + offset, KeyStrings[i], keyLength) == 0)
+			{
+				KeyMatches& m = matches[i];
+				if (m.count < MaxRecordedMatches)
+				{
+					m.offsets[m.count++] = (uint16_t)offset;
+				}
+				else
+				{
+					m.overflowed = true;
+				}
+			}
+		}
+	}
+}
+
+// Return a pointer to the first occurrence of key k at or after 'from' in the buffer that was last scanned, or nullptr if there isn't one.
+// This gives the same result as strstr(from, GetKeyString(k)) unless the buffer contains a null character before the end.
+const char *_ecv_array null FileInfoMatcher::Find(Key k, const char *_ecv_array from) const noexcept
+{
+	const KeyMatches& m = matches[(unsigned int)k];
+	for (size_t i = 0; i < m.count; ++i)
+	{
+		const char *_ecv_array const p = bufferStart + m.offsets[i];
+		if (p >= from)
+		{
+			return p;
+		}
+	}
+
+	if (m.overflowed)
+	{
+		// There were too many occurrences to record them all, so search beyond the last one we recorded
+		const char *_ecv_array const lastRecorded = bufferStart + m.offsets[MaxRecordedMatches - 1];
+		return strstr((from > lastRecorded) ? from : lastRecorded + 1, KeyStrings[(unsigned int)k]);
+	}
+	return nullptr;
+}
+
+#endif
+
+// End
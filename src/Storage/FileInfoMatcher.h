@@ -0,0 +1,74 @@
+/*
+ * FileInfoMatcher.h
+ *
+ *  Created on: 17 Oct 2026
+ *
+ * Multi-pattern matcher used by FileInfoParser. Instead of each of the FindXxx functions calling strstr once per key string on every buffer,
+ * Scan() makes a single pass over the buffer looking for all the key strings at once and records where each one occurs.
+ * The FindXxx functions then ask for the next occurrence of a key using Find(), which is usually just a table lookup.
+ *
+ * At each position in the buffer we hash the next two characters and use the hash to index a table built at compile time,
+ * giving a bitmap of the keys that might start there. Only those keys are compared. In G-code the common character pairs such as "G1" and " X"
+ * don't start any key, so most positions are rejected after one table lookup. This uses much less memory than an Aho-Corasick automaton,
+ * which matters more to us than the last few percent of speed.
+ */
+
+#ifndef SRC_STORAGE_FILEINFOMATCHER_H_
+#define SRC_STORAGE_FILEINFOMATCHER_H_
+
+#include <RepRapFirmware.h>
+
+#if HAS_MASS_STORAGE || HAS_EMBEDDED_FILES
+
+class FileInfoMatcher
+{
+public:
+	// The keys that we look for. Where a FindXxx function tries several keys in turn, they must be consecutive and in the order in which they are tried.
+	enum class Key : uint8_t
+	{
+		// Layer height
+		layer_height, LayerHeightCura, layerHeight, layer_thickness_mm, layerThickness, sliceHeight,
+		// Number of layers
+		num_layers, NUM_LAYERS,
+		// Slicer name
+		generatedByKisslicer, generatedByCuraOld, generatedByFusion, generatedBySlic3r, generatedByIdeamaker, generatedByCuraNew, generatedByKirimoto,
+		generatedByPathio, generatedByMatterControl,
+		// Print time
+		printTimeSlic3rNormal, printTimeSlic3r, printTimeCura, printTimeS3d, printTimeKisslicer, printTimeIdeamaker, printTimePathio, printTimeFusion,
+		printTimeMatterControl,
+		// Simulated print time
+		simulatedTime,
+		// Filament used
+		filamentUsed, materialNumber, extruderNumber, filamentLength, kisslicerExt, kisslicerVolume, pathioVolume,
+		// Thumbnails
+		thumbnail,
+
+		numKeys
+	};
+
+	static constexpr unsigned int NumKeys = (unsigned int)Key::numKeys;
+	static_assert(NumKeys <= 64);
+
+	static const char *_ecv_array GetKeyString(Key k) noexcept;
+	static size_t GetKeyLength(Key k) noexcept;
+
+	void Scan(const char *_ecv_array buf, size_t len) noexcept;					// find all the keys in a null-terminated buffer
+	const char *_ecv_array null Find(Key k, const char *_ecv_array from) const noexcept;	// return the first occurrence of key k at or after 'from', or nullptr
+
+private:
+	static constexpr size_t MaxRecordedMatches = 4;								// if a key occurs more often than this in one buffer, Find falls back to strstr
+
+	struct KeyMatches
+	{
+		uint16_t offsets[MaxRecordedMatches];
+		uint8_t count;
+		bool overflowed;
+	};
+
+	const char *_ecv_array bufferStart;
+	KeyMatches matches[NumKeys];
+};
+
+#endif
+
+#endif /* SRC_STORAGE_FILEINFOMATCHER_H_ */
@@ -11,6 +11,7 @@
 #include <Platform/Platform.h>
 #include <PrintMonitor/PrintMonitor.h>
 #include <GCodes/GCodes.h>
+#include <GCodes/CompactGCode.h>
 
 #if HAS_MASS_STORAGE || HAS_EMBEDDED_FILES
 
@@ -53,6 +54,14 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 			return GCodeResult::ok;
 		}
 
+#if SUPPORT_FILE_INFO_CACHE
+		// If we parsed this file before and it hasn't changed since, we don't need to open it
+		if (cache.Find(filePath, info))
+		{
+			return GCodeResult::ok;
+		}
+#endif
+
 		fileBeingParsed = MassStorage::OpenFile(filePath, OpenMode::read, 0);
 		if (fileBeingParsed == nullptr)
 		{
@@ -64,6 +73,9 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 		// File has been opened, let's start now
 		filenameBeingParsed.copy(filePath);
 		fileOverlapLength = 0;
+#if SUPPORT_COMPACT_GCODE
+		isCompactFile = false;
+#endif
 
 		// Set up the info struct
 		parsedFileInfo.Init();
@@ -138,11 +150,21 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 				}
 				buf[sizeToScan] = 0;
 
+#if SUPPORT_COMPACT_GCODE
+				if (bufferStartFileOffset == 0)
+				{
+					isCompactFile = sizeToScan >= CompactGCode::SignatureLength && memcmp(buf, CompactGCode::Signature, CompactGCode::SignatureLength) == 0;
+				}
+#endif
+
 				// Record performance data
 				uint32_t now = millis();
 				accumulatedReadTime += now - startTime;
 				startTime = now;
 
+				// Find all the key strings in the buffer in one pass
+				matcher.Scan(buf, sizeToScan);
+
 				// Search for filament usage (Cura puts it at the beginning of a G-code file)
 				if (parsedFileInfo.numFilaments == 0)
 				{
@@ -269,6 +291,9 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 				accumulatedReadTime += now - startTime;
 				startTime = now;
 
+				// Find all the key strings in the buffer in one pass
+				matcher.Scan(buf, sizeToScan);
+
 				bool footerInfoComplete = true;
 
 				// Search for filament used
@@ -293,7 +318,12 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 				// Search for object height
 				if (parsedFileInfo.objectHeight == 0.0)
 				{
-					if (!FindHeight(buf, sizeToScan))
+#if SUPPORT_COMPACT_GCODE
+					const bool foundHeight = (isCompactFile) ? FindHeightCompact(buf, sizeToScan) : FindHeight(buf, sizeToScan);
+#else
+					const bool foundHeight = FindHeight(buf, sizeToScan);
+#endif
+					if (!foundHeight)
 					{
 						footerInfoComplete = false;
 					}
@@ -343,14 +373,33 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 						parsedFileInfo.numLayers = lrintf(parsedFileInfo.objectHeight / parsedFileInfo.layerHeight);
 					}
 					parsedFileInfo.incomplete = false;
+#if SUPPORT_FILE_INFO_CACHE
+					cache.Store(filenameBeingParsed.c_str(), parsedFileInfo);
+#endif
 					info = parsedFileInfo;
 					return GCodeResult::ok;
 				}
 
 				// Else go back further
+				parseState = seeking;
+#if SUPPORT_COMPACT_GCODE
+				if (isCompactFile)
+				{
+					// FindHeightCompact can't decode anything before the first newline in the buffer, and there may be more move records there than fit in the overlap.
+					// So make the next chunk end at or after that newline instead of overlapping this one. Keep the chunk start a multiple of 512 bytes for read efficiency.
+					const char *_ecv_array const firstNewline = (const char *_ecv_array)memchr(buf, '\n', sizeToScan);
+					const size_t bytesBeforeNewline = (firstNewline == nullptr) ? GCODE_READ_SIZE : firstNewline - buf;
+					if (bytesBeforeNewline + 512 < GCODE_READ_SIZE)
+					{
+						fileOverlapLength = 0;
+						const FilePosition nextChunkEnd = nextSeekPos + bytesBeforeNewline + 1;
+						nextSeekPos = (nextChunkEnd <= GCODE_READ_SIZE) ? 0 : ((nextChunkEnd - GCODE_READ_SIZE + 511) & ~(FilePosition)511);
+						break;
+					}
+				}
+#endif
 				fileOverlapLength = (size_t)min<FilePosition>(sizeToScan, GCODE_OVERLAP_SIZE);
 				nextSeekPos = (nextSeekPos <= GCODE_READ_SIZE) ? 0 : nextSeekPos - GCODE_READ_SIZE;
-				parseState = seeking;
 			}
 			break;
 
@@ -374,6 +423,16 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 	return GCodeResult::notFinished;
 }
 
+#if SUPPORT_FILE_INFO_CACHE
+
+void FileInfoParser::Diagnostics(MessageType mtype) noexcept
+{
+	MutexLocker lock(parserMutex);
+	cache.Diagnostics(mtype);
+}
+
+#endif
+
 // Scan the buffer for a G1 Zxxx command. The buffer is null-terminated.
 // This parsing algorithm needs to be fast. The old one sometimes took 5 seconds or more to parse about 120K of data.
 // To speed up parsing, we now parse forwards from the start of the buffer. This means we can't stop when we have found a G1 Z command,
@@ -487,31 +546,125 @@ bool FileInfoParser::FindHeight(const char* bufp, size_t len) noexcept
 	return foundHeight;
 }
 
-// Scan the buffer for th total number of layers. The buffer is null-terminated.
-bool FileInfoParser::FindNumLayers(const char* bufp, size_t len) noexcept
+#if SUPPORT_COMPACT_GCODE
+
+// Scan a buffer from a compact G-code file for the last move to a new Z height. This is the equivalent of FindHeight for compact files.
+// Every byte of a move record has the top bit set, so we can start decoding after the first newline in the buffer.
+bool FileInfoParser::FindHeightCompact(const char *_ecv_array bufp, size_t len) noexcept
 {
-	static const char* const numLayerStrings[] =
+	const char *_ecv_array p = (const char *_ecv_array)memchr(bufp, '\n', len);
+	if (p == nullptr)
 	{
-		"num_layers",
-		"NUM_LAYERS"
-	};
+		return false;
+	}
+
+	const char *_ecv_array const end = bufp + len;
+	bool foundHeight = false;
+	bool inRelativeMode = false;
+	++p;
+	while (p < end)
+	{
+		const uint8_t tag = (uint8_t)*p++;
+		if ((tag & CompactGCode::MoveRecordFlag) != 0)
+		{
+			// It's a move record. If it is malformed then the file is corrupt, so stop looking.
+			for (unsigned int i = 0; i < CompactGCode::NumParameters; ++i)
+			{
+				if ((tag & (1u << i)) != 0)
+				{
+					const char *_ecv_array const valueStart = p;
+					uint32_t raw = 0;
+					unsigned int shift = 0;
+					uint8_t b;
+					do
+					{
+						if (p == end || p - valueStart == (ptrdiff_t)CompactGCode::MaxVarintLength)
+						{
+							return foundHeight;						// the record runs off the end of the buffer or the value is too long
+						}
+						b = (uint8_t)*p++;
+						if ((b & CompactGCode::VarintByteFlag) == 0)
+						{
+							return foundHeight;						// not part of a varint, for example a newline
+						}
+						if (shift < 32)
+						{
+							raw |= (uint32_t)(b & CompactGCode::VarintPayloadMask) << shift;
+						}
+						shift += CompactGCode::VarintPayloadBits;
+					} while ((b & CompactGCode::VarintMoreFlag) != 0);
 
+					if (CompactGCode::ParameterLetters[i] == 'Z' && !inRelativeMode)
+					{
+						parsedFileInfo.objectHeight = CompactGCode::DecodeValue(raw, i);
+						foundHeight = true;
+					}
+				}
+			}
+		}
+		else
+		{
+			// It's a line of text. Look for G90, G91 and any G0 or G1 command with a Z parameter that wasn't converted to a move record.
+			const char *_ecv_array const lineEnd = (const char *_ecv_array)memchr(p - 1, '\n', end - (p - 1));
+			if (lineEnd == nullptr)
+			{
+				break;
+			}
+			--p;
+			while (*p == ' ' || *p == '\t')
+			{
+				++p;
+			}
+			if (lineEnd - p >= 3 && p[0] == 'G' && p[1] == '9' && (p[2] == '0' || p[2] == '1') && (lineEnd - p == 3 || p[3] < '0' || p[3] > '9'))
+			{
+				inRelativeMode = (p[2] == '1');
+			}
+			else if (!inRelativeMode && lineEnd - p >= 2 && p[0] == 'G' && (p[1] == '0' || p[1] == '1') && (lineEnd - p == 2 || p[2] < '0' || p[2] > '9'))
+			{
+				// As in FindHeight, ignore commands with a comment starting with E
+				const char *_ecv_array const comment = (const char *_ecv_array)memchr(p, ';', lineEnd - p);
+				const bool ignore = comment != nullptr && (comment[1] == 'E' || (comment[1] == ' ' && comment[2] == 'E'));
+				for (const char *_ecv_array q = p + 2; !ignore && q < lineEnd && *q != ';'; ++q)
+				{
+					if (*q == 'Z')
+					{
+						const float objectHeight = SafeStrtof(q + 1, nullptr);
+						if (!std::isnan(objectHeight) && !std::isinf(objectHeight))
+						{
+							parsedFileInfo.objectHeight = objectHeight;
+							foundHeight = true;
+						}
+						break;
+					}
+				}
+			}
+			p = lineEnd + 1;
+		}
+	}
+	return foundHeight;
+}
+
+#endif
+
+// Scan the buffer for th total number of layers. The buffer is null-terminated.
+bool FileInfoParser::FindNumLayers(const char* bufp, size_t len) noexcept
+{
 	if (*bufp != 0)
 	{
 		++bufp;														// make sure we can look back 1 character after we find a match
-		for (const char * lhStr : numLayerStrings)					// search for each string in turn
+		for (unsigned int k = (unsigned int)FileInfoMatcher::Key::num_layers; k <= (unsigned int)FileInfoMatcher::Key::NUM_LAYERS; ++k)	// search for each string in turn
 		{
 			const char *pos = bufp;
-			for(;;)													// loop until success or strstr returns null
+			for(;;)													// loop until success or there are no more matches
 			{
-				pos = strstr(pos, lhStr);
+				pos = matcher.Find((FileInfoMatcher::Key)k, pos);
 				if (pos == nullptr)
 				{
 					break;											// didn't find this string in the buffer, so try the next string
 				}
 
 				const char c = pos[-1];								// fetch the previous character
-				pos += strlen(lhStr);								// skip the string we matched
+				pos += FileInfoMatcher::GetKeyLength((FileInfoMatcher::Key)k);	// skip the string we matched
 				if (c == ' ' || c == ';' || c == '\t')				// check we are not in the middle of a word
 				{
 					while (strchr(" \t=:,", *pos) != nullptr)		// skip the possible separators
@@ -535,32 +688,22 @@ bool FileInfoParser::FindNumLayers(const char* bufp, size_t len) noexcept
 // Scan the buffer for the layer height. The buffer is null-terminated.
 bool FileInfoParser::FindLayerHeight(const char *bufp) noexcept
 {
-	static const char* const layerHeightStrings[] =
-	{
-		"layer_height",			// slic3r
-		"Layer height",			// Cura
-		"layerHeight",			// S3D
-		"layer_thickness_mm",	// Kisslicer
-		"layerThickness",		// Matter Control
-		"sliceHeight"			// kiri:moto
-	};
-
 	if (*bufp != 0)
 	{
 		++bufp;														// make sure we can look back 1 character after we find a match
-		for (const char * lhStr : layerHeightStrings)				// search for each string in turn
+		for (unsigned int k = (unsigned int)FileInfoMatcher::Key::layer_height; k <= (unsigned int)FileInfoMatcher::Key::sliceHeight; ++k)	// search for each string in turn
 		{
 			const char *pos = bufp;
-			for(;;)													// loop until success or strstr returns null
+			for(;;)													// loop until success or there are no more matches
 			{
-				pos = strstr(pos, lhStr);
+				pos = matcher.Find((FileInfoMatcher::Key)k, pos);
 				if (pos == nullptr)
 				{
 					break;											// didn't find this string in the buffer, so try the next string
 				}
 
 				const char c = pos[-1];								// fetch the previous character
-				pos += strlen(lhStr);								// skip the string we matched
+				pos += FileInfoMatcher::GetKeyLength((FileInfoMatcher::Key)k);	// skip the string we matched
 				if (c == ' ' || c == ';' || c == '\t')				// check we are not in the middle of a word
 				{
 					while (strchr(" \t=:,", *pos) != nullptr)		// skip the possible separators
@@ -582,52 +725,46 @@ bool FileInfoParser::FindLayerHeight(const char *bufp) noexcept
 	return false;
 }
 
-bool FileInfoParser::FindSlicerInfo(const char* bufp) noexcept
+// Find the first of the keys from 'first' to 'last' inclusive that occurs in the buffer at or after bufp.
+// If we find one, return true with 'found' set to the key and 'pos' to its first occurrence.
+bool FileInfoParser::FindFirstKey(FileInfoMatcher::Key first, FileInfoMatcher::Key last, const char *_ecv_array bufp, FileInfoMatcher::Key& found, const char *_ecv_array& pos) const noexcept
 {
-	static const char * const GeneratedByStrings[] =
-	{
-		"; KISSlicer",		// KISSlicer
-		";Sliced at: ",		// Cura (old)
-		";Fusion version:",	// Fusion 360
-		"generated by ",	// slic3r and S3D
-		";Sliced by ",		// ideaMaker
-		";Generated with ",	// Cura (new)
-		"; Generated by ",	// kiri:moto
-		";GENERATOR.NAME:",	// Pathio (the version is separate, we don't include that)
-		"; Generated with "	// Matter Control
-	};
-
-	size_t index = 0;
-	const char* pos;
-	do
+	for (unsigned int k = (unsigned int)first; k <= (unsigned int)last; ++k)
 	{
-		pos = strstr(bufp, GeneratedByStrings[index]);
-		if (pos != nullptr)
+		const char *_ecv_array const p = matcher.Find((FileInfoMatcher::Key)k, bufp);
+		if (p != nullptr)
 		{
-			break;
+			found = (FileInfoMatcher::Key)k;
+			pos = p;
+			return true;
 		}
-		++index;
-	} while (index < ARRAY_SIZE(GeneratedByStrings));
+	}
+	return false;
+}
 
-	if (pos != nullptr)
+bool FileInfoParser::FindSlicerInfo(const char* bufp) noexcept
+{
+	FileInfoMatcher::Key key;
+	const char* pos;
+	if (FindFirstKey(FileInfoMatcher::Key::generatedByKisslicer, FileInfoMatcher::Key::generatedByMatterControl, bufp, key, pos))
 	{
 		const char* introString = "";
-		switch (index)
+		switch (key)
 		{
 		default:
-			pos += strlen(GeneratedByStrings[index]);
+			pos += FileInfoMatcher::GetKeyLength(key);
 			break;
 
-		case 0:		// KISSlicer
+		case FileInfoMatcher::Key::generatedByKisslicer:
 			pos += 2;
 			break;
 
-		case 1:		// Cura (old)
+		case FileInfoMatcher::Key::generatedByCuraOld:
 			introString = "Cura at ";
-			pos += strlen(GeneratedByStrings[index]);
+			pos += FileInfoMatcher::GetKeyLength(key);
 			break;
 
-		case 2:		// Fusion 360
+		case FileInfoMatcher::Key::generatedByFusion:
 			pos += 1;
 			break;
 		}
@@ -643,12 +780,12 @@ bool FileInfoParser::FindSlicerInfo(const char* bufp) noexcept
 }
 
 // Scan the buffer for a 2-part filament used string. Return the number of filament found.
-void FileInfoParser::FindFilamentUsedEmbedded(const char* p, const char *s1, const char *s2, unsigned int &filamentsFound) noexcept
+void FileInfoParser::FindFilamentUsedEmbedded(const char* p, FileInfoMatcher::Key k1, const char *s2, unsigned int &filamentsFound) noexcept
 {
 	const size_t maxFilaments = reprap.GetGCodes().GetNumExtruders();
-	while (filamentsFound < maxFilaments &&	(p = strstr(p, s1)) != nullptr)
+	while (filamentsFound < maxFilaments &&	(p = matcher.Find(k1, p)) != nullptr)
 	{
-		p += strlen(s1);
+		p += FileInfoMatcher::GetKeyLength(k1);
 		const char *q1, *q2;
 		uint32_t num = StrToU32(p, &q1);
 		if (q1 != p && num < maxFilaments && (q2 = strstr(q1, s2)) == q1)
@@ -678,11 +815,10 @@ unsigned int FileInfoParser::FindFilamentUsed(const char* bufp) noexcept
 	unsigned int filamentsFound = 0;
 
 	// Look for filament usage as generated by Slic3r and Cura
-	const char* const filamentUsedStr1 = "ilament used";			// comment string used by slic3r and Cura, followed by filament used and "mm"
 	const char* p = bufp;
-	while (filamentsFound < MaxFilaments &&	(p = strstr(p, filamentUsedStr1)) != nullptr)
+	while (filamentsFound < MaxFilaments &&	(p = matcher.Find(FileInfoMatcher::Key::filamentUsed, p)) != nullptr)
 	{
-		p += strlen(filamentUsedStr1);
+		p += FileInfoMatcher::GetKeyLength(FileInfoMatcher::Key::filamentUsed);
 		while(strchr(" [m]:=\t", *p) != nullptr)					// Prusa slicer now uses "; filament used [mm] = 4235.9"
 		{
 			++p;	// this allows for " = " from default slic3r comment and ": " from default Cura comment
@@ -717,20 +853,19 @@ unsigned int FileInfoParser::FindFilamentUsed(const char* bufp) noexcept
 	}
 
 	// Look for filament usage strings generated by Ideamaker, e.g. ";Material#1 Used: 868.0"
-	FindFilamentUsedEmbedded(bufp, ";Material#", " Used", filamentsFound);
+	FindFilamentUsedEmbedded(bufp, FileInfoMatcher::Key::materialNumber, " Used", filamentsFound);
 
 	// Look for filament usage strings generated by Fusion 360, e.g. ";Extruder 1 material used: 1811mm"
-	FindFilamentUsedEmbedded(bufp, ";Extruder ", " material used", filamentsFound);
+	FindFilamentUsedEmbedded(bufp, FileInfoMatcher::Key::extruderNumber, " material used", filamentsFound);
 
 
 	// Look for filament usage as generated by S3D
 	if (filamentsFound == 0)
 	{
-		const char *filamentLengthStr = "ilament length";	// comment string used by S3D
 		p = bufp;
-		while (filamentsFound < MaxFilaments &&	(p = strstr(p, filamentLengthStr)) != nullptr)
+		while (filamentsFound < MaxFilaments &&	(p = matcher.Find(FileInfoMatcher::Key::filamentLength, p)) != nullptr)
 		{
-			p += strlen(filamentLengthStr);
+			p += FileInfoMatcher::GetKeyLength(FileInfoMatcher::Key::filamentLength);
 			while(strchr(" :=\t", *p) != nullptr)
 			{
 				++p;
@@ -750,11 +885,10 @@ unsigned int FileInfoParser::FindFilamentUsed(const char* bufp) noexcept
 	// Look for filament usage as generated by recent KISSlicer versions
 	if (filamentsFound == 0)
 	{
-		const char *filamentLengthStr = ";    Ext ";
 		p = bufp;
-		while (filamentsFound < MaxFilaments && (p = strstr(p, filamentLengthStr)) != nullptr)
+		while (filamentsFound < MaxFilaments && (p = matcher.Find(FileInfoMatcher::Key::kisslicerExt, p)) != nullptr)
 		{
-			p += strlen(filamentLengthStr);
+			p += FileInfoMatcher::GetKeyLength(FileInfoMatcher::Key::kisslicerExt);
 			if (*p == '#')
 			{
 				++p;				// later KISSlicer versions add a # here
@@ -783,18 +917,18 @@ unsigned int FileInfoParser::FindFilamentUsed(const char* bufp) noexcept
 	// Special case: Old KISSlicer and Pathio only generate the filament volume, so we need to calculate the length from it
 	if (filamentsFound == 0 && reprap.GetPlatform().GetFilamentWidth() > 0.0)
 	{
-		const char *filamentVolumeStr = "; Estimated Build Volume: ";				// old KISSlicer
+		FileInfoMatcher::Key volumeKey = FileInfoMatcher::Key::kisslicerVolume;	// old KISSlicer
 		float multipler = 1000.0;													// volume is in cm^3
-		p = strstr(bufp, filamentVolumeStr);
+		p = matcher.Find(volumeKey, bufp);
 		if (p == nullptr)
 		{
-			filamentVolumeStr = ";EXTRUDER_TRAIN.0.MATERIAL.VOLUME_USED:";			// Pathio
+			volumeKey = FileInfoMatcher::Key::pathioVolume;							// Pathio
 			multipler = 1.0;														// volume is in mm^3
-			p = strstr(bufp, filamentVolumeStr);
+			p = matcher.Find(volumeKey, bufp);
 		}
 		if (p != nullptr)
 		{
-			const float filamentCMM = SafeStrtof(p + strlen(filamentVolumeStr), nullptr) * multipler;
+			const float filamentCMM = SafeStrtof(p + FileInfoMatcher::GetKeyLength(volumeKey), nullptr) * multipler;
 			if (!std::isnan(filamentCMM) && !std::isinf(filamentCMM))
 			{
 				parsedFileInfo.filamentNeeded[filamentsFound++] = filamentCMM / (Pi * fsquare(reprap.GetPlatform().GetFilamentWidth() * 0.5));
@@ -808,123 +942,105 @@ unsigned int FileInfoParser::FindFilamentUsed(const char* bufp) noexcept
 // Scan the buffer for the estimated print time
 bool FileInfoParser::FindPrintTime(const char* bufp) noexcept
 {
-	static const char* const PrintTimeStrings[] =
-	{
-		// Note: if a string in this table is a leading or embedded substring of another, the longer one must come first
-		" estimated printing time (normal mode)",	// slic3r PE later versions			"; estimated printing time (normal mode) = 2d 1h 5m 24s"
-		" estimated printing time",					// slic3r PE older versions			"; estimated printing time = 1h 5m 24s"
-		";TIME",									// Cura								";TIME:38846"
-		" Build time",								// S3D								";   Build time: 0 hours 42 minutes"
-													// also REALvision					"; Build time: 2:11:47"
-		" Build Time",								// KISSlicer						"; Estimated Build Time:   332.83 minutes"
-													// also KISSSlicer 2 alpha			"; Calculated-during-export Build Time: 130.62 minutes"
-		";Print Time:",								// Ideamaker
-		";PRINT.TIME:",								// Patio
-		";Print time:",								// Fusion 360
-		"; total print time (s) ="					// Matter Control
-	};
-
-	for (const char * ptStr : PrintTimeStrings)
+	FileInfoMatcher::Key key;
+	const char* pos;
+	if (FindFirstKey(FileInfoMatcher::Key::printTimeSlic3rNormal, FileInfoMatcher::Key::printTimeMatterControl, bufp, key, pos))
 	{
-		const char* pos = strstr(bufp, ptStr);
-		if (pos != nullptr)
+		pos += FileInfoMatcher::GetKeyLength(key);
+		while (strchr(" \t=:", *pos))
 		{
-			pos += strlen(ptStr);
-			while (strchr(" \t=:", *pos))
+			++pos;
+		}
+		const char * const q = pos;
+		float days = 0.0, hours = 0.0, minutes = 0.0;
+		float secs = SafeStrtof(pos, &pos);
+		if (q != pos)
+		{
+			while (*pos == ' ')
 			{
 				++pos;
 			}
-			const char * const q = pos;
-			float days = 0.0, hours = 0.0, minutes = 0.0;
-			float secs = SafeStrtof(pos, &pos);
-			if (q != pos)
+			if (*pos == ':')											// special code for REALvision
 			{
-				while (*pos == ' ')
-				{
-					++pos;
-				}
-				if (*pos == ':')											// special code for REALvision
+				minutes = secs;
+				secs = SafeStrtof(pos + 1, &pos);
+				if (*pos == ':')
 				{
+					hours = minutes;
 					minutes = secs;
 					secs = SafeStrtof(pos + 1, &pos);
-					if (*pos == ':')
-					{
-						hours = minutes;
-						minutes = secs;
-						secs = SafeStrtof(pos + 1, &pos);
-						// I am assuming that it stops at hours
-					}
+					// I am assuming that it stops at hours
 				}
-				else
+			}
+			else
+			{
+				if (*pos == 'd')
 				{
-					if (*pos == 'd')
+					days = secs;
+					if (StringStartsWithIgnoreCase(pos, "day"))			// not sure if any slicer needs this, but include it j.i.c.
 					{
-						days = secs;
-						if (StringStartsWithIgnoreCase(pos, "day"))			// not sure if any slicer needs this, but include it j.i.c.
-						{
-							pos += 3;
-							if (*pos == 's')
-							{
-								++pos;
-							}
-						}
-						else
-						{
-							++pos;
-						}
-						secs = SafeStrtof(pos, &pos);
-						while (*pos == ' ' || *pos == ':')
+						pos += 3;
+						if (*pos == 's')
 						{
 							++pos;
 						}
 					}
-					if (*pos == 'h')
+					else
+					{
+						++pos;
+					}
+					secs = SafeStrtof(pos, &pos);
+					while (*pos == ' ' || *pos == ':')
 					{
-						hours = secs;
-						if (StringStartsWithIgnoreCase(pos, "hour"))		// S3D
-						{
-							pos += 4;
-							if (*pos == 's')
-							{
-								++pos;
-							}
-						}
-						else
-						{
-							++pos;
-						}
-						secs = SafeStrtof(pos, &pos);
-						while (*pos == ' ' || *pos == ':')					// Fusion 360 gives e.g. ";Print time: 40m:36s"
+						++pos;
+					}
+				}
+				if (*pos == 'h')
+				{
+					hours = secs;
+					if (StringStartsWithIgnoreCase(pos, "hour"))		// S3D
+					{
+						pos += 4;
+						if (*pos == 's')
 						{
 							++pos;
 						}
 					}
-					if (*pos == 'm')
+					else
 					{
-						minutes = secs;
-						if (StringStartsWithIgnoreCase(pos, "minute"))
-						{
-							pos += 6;
-							if (*pos == 's')
-							{
-								++pos;
-							}
-						}
-						else if (StringStartsWithIgnoreCase(pos, "min"))	// Fusion 360
-						{
-							pos += 3;
-						}
-						else
+						++pos;
+					}
+					secs = SafeStrtof(pos, &pos);
+					while (*pos == ' ' || *pos == ':')					// Fusion 360 gives e.g. ";Print time: 40m:36s"
+					{
+						++pos;
+					}
+				}
+				if (*pos == 'm')
+				{
+					minutes = secs;
+					if (StringStartsWithIgnoreCase(pos, "minute"))
+					{
+						pos += 6;
+						if (*pos == 's')
 						{
 							++pos;
 						}
-						secs = SafeStrtof(pos, &pos);
 					}
+					else if (StringStartsWithIgnoreCase(pos, "min"))	// Fusion 360
+					{
+						pos += 3;
+					}
+					else
+					{
+						++pos;
+					}
+					secs = SafeStrtof(pos, &pos);
 				}
 			}
-			parsedFileInfo.printTime = lrintf(((days * 24.0 + hours) * 60.0 + minutes) * 60.0 + secs);
-			return true;
 		}
+		parsedFileInfo.printTime = lrintf(((days * 24.0 + hours) * 60.0 + minutes) * 60.0 + secs);
+		return true;
 	}
 	return false;
 }
@@ -932,10 +1048,10 @@ bool FileInfoParser::FindPrintTime(const char* bufp) noexcept
 // Scan the buffer for the simulated print time
 bool FileInfoParser::FindSimulatedTime(const char* bufp) noexcept
 {
-	const char* pos = strstr(bufp, SimulatedTimeString);
+	const char* pos = matcher.Find(FileInfoMatcher::Key::simulatedTime, bufp);
 	if (pos != nullptr)
 	{
-		pos += strlen(SimulatedTimeString);
+		pos += FileInfoMatcher::GetKeyLength(FileInfoMatcher::Key::simulatedTime);
 		while (strchr(" \t=:", *pos))
 		{
 			++pos;
@@ -972,7 +1088,6 @@ bool FileInfoParser::FindThumbnails(const char *_ecv_array bufp, FilePosition bu
 		}
 	}
 
-	constexpr const char *_ecv_array ThumbnailText = "; thumbnail";
 	constexpr const char *_ecv_array QoiBeginText = "_QOI begin ";
 	constexpr const char *_ecv_array JpegBeginText = "_JPG begin ";
 	constexpr const char *_ecv_array PngBeginText = " begin ";
@@ -980,13 +1095,13 @@ bool FileInfoParser::FindThumbnails(const char *_ecv_array bufp, FilePosition bu
 	const char *_ecv_array pos = bufp;
 	while (true)
 	{
-		pos = strstr(pos, ThumbnailText);
+		pos = matcher.Find(FileInfoMatcher::Key::thumbnail, pos);
 		if (pos == nullptr)
 		{
 			return false;
 		}
 
-		pos += strlen(ThumbnailText);
+		pos += FileInfoMatcher::GetKeyLength(FileInfoMatcher::Key::thumbnail);
 		GCodeFileInfo::ThumbnailInfo::Format fmt(GCodeFileInfo::ThumbnailInfo::Format::qoi);
 		if (StringStartsWith(pos, QoiBeginText))
 		{
@@ -10,6 +10,8 @@
 
 #include <RepRapFirmware.h>
 #include <GCodes/GCodeFileInfo.h>
+#include "FileInfoCache.h"
+#include "FileInfoMatcher.h"
 
 #if HAS_MASS_STORAGE || HAS_EMBEDDED_FILES
 
@@ -49,17 +51,25 @@ public:
 
 	static constexpr const char *_ecv_array SimulatedTimeString = "\n; Simulated print time";	// used by FileInfoParser and MassStorage
 
+#if SUPPORT_FILE_INFO_CACHE
+	void Diagnostics(MessageType mtype) noexcept;
+#endif
+
 private:
 
 	// G-Code parser methods
 	bool FindHeight(const char *_ecv_array bufp, size_t len) noexcept;
+#if SUPPORT_COMPACT_GCODE
+	bool FindHeightCompact(const char *_ecv_array bufp, size_t len) noexcept;
+#endif
 	bool FindNumLayers(const char *_ecv_array bufp, size_t len) noexcept;
 	bool FindLayerHeight(const char *_ecv_array bufp) noexcept;
 	bool FindSlicerInfo(const char *_ecv_array bufp) noexcept;
 	bool FindPrintTime(const char *_ecv_array bufp) noexcept;
 	bool FindSimulatedTime(const char *_ecv_array bufp) noexcept;
 	unsigned int FindFilamentUsed(const char *_ecv_array bufp) noexcept;
-	void FindFilamentUsedEmbedded(const char *_ecv_array p, const char *_ecv_array s1, const char *_ecv_array s2, unsigned int &filamentsFound) noexcept;
+	void FindFilamentUsedEmbedded(const char *_ecv_array p, FileInfoMatcher::Key k1, const char *_ecv_array s2, unsigned int &filamentsFound) noexcept;
+	bool FindFirstKey(FileInfoMatcher::Key first, FileInfoMatcher::Key last, const char *_ecv_array bufp, FileInfoMatcher::Key& found, const char *_ecv_array& pos) const noexcept;
 	bool FindThumbnails(const char *_ecv_array bufp, FilePosition bufferStartFilePosition) noexcept;
 
 	// We parse G-Code files in multiple stages. These variables hold the required information
@@ -73,6 +83,14 @@ private:
 	uint32_t lastFileParseTime;
 	uint32_t accumulatedParseTime, accumulatedReadTime, accumulatedSeekTime;
 	size_t fileOverlapLength;
+#if SUPPORT_COMPACT_GCODE
+	bool isCompactFile;										// true if the file being parsed is in compact G-code format
+#endif
+	FileInfoMatcher matcher;								// records where the key strings occur in buf
+
+#if SUPPORT_FILE_INFO_CACHE
+	FileInfoCache cache;
+#endif
 
 	// We used to allocate the following buffer on the stack; but now that this is called by more than one task
 	// it is more economical to allocate it permanently because that lets us use smaller stacks.
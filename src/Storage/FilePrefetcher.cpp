@@ -0,0 +1,129 @@
+/*
+ * FilePrefetcher.cpp
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include "FilePrefetcher.h"
+
+#if SUPPORT_FILE_PREFETCH
+
+#include <Platform/TaskPriorities.h>
+
+static_assert(FilePrefetchBlockSize % 512 == 0, "FilePrefetchBlockSize must be a multiple of the sector size");
+
+extern "C" [[noreturn]] void FilePrefetchTaskStart(void *p) noexcept
+{
+	static_cast<FilePrefetcher*>(p)->RunTask();
+}
+
+FilePrefetcher::FilePrefetcher() noexcept
+	: prefetchTask(nullptr), readPosition(0), readBlock(0), fillBlock(0), reachedEnd(false), hadError(false)
+{
+	blocks[0].state = blocks[1].state = BlockState::empty;
+}
+
+// Start reading ahead from the current position of the file. Must be called only when we are not attached to a file.
+void FilePrefetcher::Attach(const FileData& f) noexcept
+{
+	if (prefetchTask == nullptr)
+	{
+		fileMutex.Create("Prefetch");
+		prefetchTask = new Task<TaskStackWords>;
+		prefetchTask->Create(FilePrefetchTaskStart, "PREFETCH", (void*)this, TaskPriority::FilePrefetchPriority);
+	}
+
+	{
+		MutexLocker lock(fileMutex);
+		blocks[0].state = blocks[1].state = BlockState::empty;
+		readBlock = fillBlock = 0;
+		reachedEnd = hadError = false;
+		file.CopyFrom(f);
+		readPosition = file.GetPosition();
+	}
+	prefetchTask->Give();
+}
+
+// Stop reading ahead and leave the file positioned at the next byte that Read() would have returned
+void FilePrefetcher::Detach() noexcept
+{
+	if (file.IsLive())
+	{
+		MutexLocker lock(fileMutex);								// wait for any read in progress to complete
+		file.Seek(readPosition);
+		file.Close();
+		blocks[0].state = blocks[1].state = BlockState::empty;
+	}
+}
+
+// Return up to nBytes of the data that has been read ahead. Return 0 if no data is available yet, or -1 if the prefetch task had a read error.
+int FilePrefetcher::Read(char *_ecv_array buf, size_t nBytes) noexcept
+{
+	Block& b = blocks[readBlock];
+	if (b.state != BlockState::full)
+	{
+		return (hadError) ? -1 : 0;
+	}
+	__DMB();														// make sure we don't read the block details until we have seen that it is full
+
+	const size_t bytesToCopy = min<size_t>(nBytes, b.length - b.readOffset);
+	memcpy(buf, b.data + b.readOffset, bytesToCopy);
+	b.readOffset += bytesToCopy;
+	readPosition += bytesToCopy;
+	if (b.readOffset == b.length)
+	{
+		// We have used all of this block, so let the prefetch task fill it again
+		b.state = BlockState::empty;
+		readBlock ^= 1;
+		prefetchTask->Give();
+	}
+	return (int)bytesToCopy;
+}
+
+// Return true if all the data up to the end of file has been returned by Read().
+// The prefetch task fills the blocks in the same order that we read them, so if the next block to read is empty and the end of file has been reached then there is no more data.
+bool FilePrefetcher::IsFinished() const noexcept
+{
+	return reachedEnd && blocks[readBlock].state == BlockState::empty;
+}
+
+[[noreturn]] void FilePrefetcher::RunTask() noexcept
+{
+	for (;;)
+	{
+		(void)TaskBase::Take();
+		for (;;)
+		{
+			MutexLocker lock(fileMutex);
+			Block& b = blocks[fillBlock];
+			if (!file.IsLive() || reachedEnd || hadError || b.state != BlockState::empty)
+			{
+				break;
+			}
+
+			// Read up to the next block boundary in the file, so that after the first read all our reads are aligned to whole sectors
+			const size_t bytesToRead = FilePrefetchBlockSize - (file.GetPosition() % FilePrefetchBlockSize);
+			const int bytesRead = file.Read(b.data, bytesToRead);
+			if (bytesRead < 0)
+			{
+				hadError = true;
+			}
+			else if (bytesRead == 0)
+			{
+				reachedEnd = true;
+			}
+			else
+			{
+				b.length = (size_t)bytesRead;
+				b.readOffset = 0;
+				__DMB();											// make sure that the block details have been written first
+				b.state = BlockState::full;
+				fillBlock ^= 1;
+			}
+		}
+	}
+}
+
+#endif
+
+// End
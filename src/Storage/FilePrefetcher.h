@@ -0,0 +1,62 @@
+/*
+ * FilePrefetcher.h
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef SRC_STORAGE_FILEPREFETCHER_H_
+#define SRC_STORAGE_FILEPREFETCHER_H_
+
+#include <RepRapFirmware.h>
+
+#if SUPPORT_FILE_PREFETCH
+
+#include "FileData.h"
+#include <RTOSIface/RTOSIface.h>
+
+// Class to read ahead in a file using a separate task, so that SD card latency doesn't hold up the task that consumes the data.
+// The file is read in blocks of FilePrefetchBlockSize bytes aligned to the start of the file, so that FatFs can transfer whole sectors directly into the blocks.
+// While the prefetcher is attached to a file, the consuming task must not read, seek or get the position of that file. Detach() leaves the file positioned
+// just after the last byte that was returned by Read().
+class FilePrefetcher
+{
+public:
+	FilePrefetcher() noexcept;
+
+	void Attach(const FileData& f) noexcept;						// start reading ahead from the current position of the file
+	void Detach() noexcept;											// stop reading ahead and set the file position to the next byte that Read() would have returned
+	bool IsAttachedTo(const FileData& f) const noexcept { return file.IsLive() && file == f; }
+
+	int Read(char *_ecv_array buf, size_t nBytes) noexcept;			// return up to nBytes of the data read ahead, 0 if none is available yet, or -1 if there was an error
+	bool IsFinished() const noexcept;								// return true if all the data up to the end of file has been returned by Read()
+	FilePosition GetPosition() const noexcept { return readPosition; }	// return the file position of the next byte that Read() will return
+
+	[[noreturn]] void RunTask() noexcept;
+
+private:
+	static constexpr unsigned int TaskStackWords = 400;			// must be enough for f_read, the SD card driver and the error message that FileStore::Read may report
+
+	enum class BlockState : uint8_t { empty, full };
+
+	struct Block
+	{
+		alignas(4) char data[FilePrefetchBlockSize];
+		size_t length;												// the number of bytes in data
+		size_t readOffset;											// the number of bytes already returned by Read()
+		volatile BlockState state;
+	};
+
+	Block blocks[2];
+	FileData file;													// the file we are reading from, or not live if we are not attached
+	Mutex fileMutex;												// held by the prefetch task while it is reading the file
+	Task<TaskStackWords> *prefetchTask;
+	FilePosition readPosition;										// file position of the next byte that Read() will return
+	unsigned int readBlock;											// index of the block that Read() takes data from
+	unsigned int fillBlock;											// index of the block that the prefetch task fills next
+	volatile bool reachedEnd;										// true if the prefetch task has reached the end of file
+	volatile bool hadError;											// true if the prefetch task had a read error
+};
+
+#endif
+
+#endif /* SRC_STORAGE_FILEPREFETCHER_H_ */
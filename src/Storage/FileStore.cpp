@@ -22,6 +22,10 @@
 # include <SBC/SbcInterface.h>
 #endif
 
+#if SUPPORT_MACRO_CACHE
+# include "MacroCache.h"
+#endif
+
 FileStore::FileStore() noexcept
 #if HAS_MASS_STORAGE || HAS_SBC_INTERFACE
 	: writeBuffer(nullptr)
@@ -44,11 +48,31 @@ void FileStore::Init() noexcept
 	handle = noFileHandle;
 	length = 0;
 #endif
-#if HAS_EMBEDDED_FILES || HAS_SBC_INTERFACE
+#if SUPPORT_MACRO_CACHE
+	cachedFile = nullptr;
+	macroCacheExempt = false;
+#endif
+#if HAS_EMBEDDED_FILES || HAS_SBC_INTERFACE || SUPPORT_MACRO_CACHE
 	offset = 0;
 #endif
 }
 
+#if SUPPORT_MACRO_CACHE
+
+// Open a copy of a file that is held in the macro cache. The caller must already have marked the cache entry as in use.
+void FileStore::OpenCached(CachedMacroFile *cf) noexcept
+{
+	cachedFile = cf;
+	offset = 0;
+	writeBuffer = nullptr;
+	file.obj.fs = nullptr;										// so that we don't think this file is open on a file system
+	closeRequested = false;
+	usageMode = FileUseMode::readOnly;
+	openCount = 1;
+}
+
+#endif
+
 // Open a local file (for example on an SD card).
 // This is protected - only Platform can access it.
 bool FileStore::Open(const char *_ecv_array filePath, OpenMode mode, uint32_t preAllocSize) noexcept
@@ -163,6 +187,9 @@ bool FileStore::Open(const char *_ecv_array filePath, OpenMode mode, uint32_t pr
 	calcCrc = (mode == OpenMode::writeWithCrc);
 	usageMode = (writing) ? FileUseMode::readWrite : FileUseMode::readOnly;
 	openCount = 1;
+# if SUPPORT_MACRO_CACHE
+	macroCacheExempt = false;
+# endif
 # if HAS_MASS_STORAGE
 #  ifndef __LPC17xx__
 	if (preAllocSize != 0 && (mode == OpenMode::write || mode == OpenMode::writeWithCrc))
@@ -245,6 +272,13 @@ bool FileStore::Seek(FilePosition pos) noexcept
 
 	case FileUseMode::readOnly:
 	case FileUseMode::readWrite:
+#if SUPPORT_MACRO_CACHE
+		if (cachedFile != nullptr)
+		{
+			offset = min<FilePosition>(pos, cachedFile->length);
+			return true;
+		}
+#endif
 #if HAS_SBC_INTERFACE
 		if (reprap.UsingSbcInterface())
 		{
@@ -273,6 +307,12 @@ bool FileStore::Seek(FilePosition pos) noexcept
 
 FilePosition FileStore::Position() const noexcept
 {
+#if SUPPORT_MACRO_CACHE
+	if (cachedFile != nullptr)
+	{
+		return offset;
+	}
+#endif
 #if HAS_SBC_INTERFACE
 	if (reprap.UsingSbcInterface())
 	{
@@ -297,6 +337,12 @@ FilePosition FileStore::Length() const noexcept
 		return 0;
 
 	case FileUseMode::readOnly:
+#if SUPPORT_MACRO_CACHE
+		if (cachedFile != nullptr)
+		{
+			return cachedFile->length;
+		}
+#endif
 #if HAS_SBC_INTERFACE
 		if (reprap.UsingSbcInterface())
 		{
@@ -383,6 +429,15 @@ int FileStore::Read(char *_ecv_array extBuf, size_t nBytes) noexcept
 
 	case FileUseMode::readOnly:
 	case FileUseMode::readWrite:
+#if SUPPORT_MACRO_CACHE
+		if (cachedFile != nullptr)
+		{
+			const size_t bytesToCopy = min<size_t>(nBytes, cachedFile->length - offset);
+			memcpy(extBuf, cachedFile->data + offset, bytesToCopy);
+			offset += bytesToCopy;
+			return (int)bytesToCopy;
+		}
+#endif
 #if HAS_SBC_INTERFACE
 		if (reprap.UsingSbcInterface())
 		{
@@ -461,6 +516,18 @@ int FileStore::ReadLine(char *_ecv_array buf, size_t nBytes) noexcept
 
 bool FileStore::ForceClose() noexcept
 {
+#if SUPPORT_MACRO_CACHE
+	if (cachedFile != nullptr)
+	{
+		MacroCache::Release(cachedFile);
+		cachedFile = nullptr;
+		usageMode = FileUseMode::free;
+		closeRequested = false;
+		openCount = 0;
+		return true;
+	}
+#endif
+
 #if HAS_MASS_STORAGE || HAS_SBC_INTERFACE
 	bool ok = true;
 	if (usageMode == FileUseMode::readWrite)
@@ -487,11 +554,20 @@ bool FileStore::ForceClose() noexcept
 #endif
 
 #if HAS_MASS_STORAGE
+# if SUPPORT_MACRO_CACHE
+	const bool wasWriting = (usageMode == FileUseMode::readWrite);
+# endif
 	const FRESULT fr = f_close(&file);
 	usageMode = FileUseMode::free;
 	closeRequested = false;
 	openCount = 0;
 	reprap.VolumesUpdated();
+# if SUPPORT_MACRO_CACHE
+	if (wasWriting && !macroCacheExempt)
+	{
+		MacroCache::FilesChanged();					// the file may have been read into the macro cache before we finished writing it
+	}
+# endif
 	return ok && fr == FR_OK;
 #endif
 
@@ -731,6 +807,12 @@ bool FileStore::IsSameFile(const FIL& otherFile) const noexcept
 
 uint32_t FileStore::ClusterSize() const noexcept
 {
+# if SUPPORT_MACRO_CACHE
+	if (cachedFile != nullptr)
+	{
+		return 1;
+	}
+# endif
 	return (usageMode == FileUseMode::readOnly || usageMode == FileUseMode::readWrite) ? file.obj.fs->csize * 512u : 1;	// we divide by the cluster size so return 1 not 0 if there is an error
 }
 
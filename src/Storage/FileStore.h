@@ -13,6 +13,7 @@
 
 class Platform;
 class FileWriteBuffer;
+struct CachedMacroFile;
 
 #if HAS_EMBEDDED_FILES
 typedef int32_t FileIndex;
@@ -58,6 +59,10 @@ public:
 	bool IsFree() const noexcept { return usageMode == FileUseMode::free; }
 	FilePosition Position() const noexcept;						// Return the current position in the file, assuming we are reading the file
 	void Duplicate() noexcept;									// Create a second reference to this file
+#if SUPPORT_MACRO_CACHE
+	void OpenCached(CachedMacroFile *cf) noexcept;				// Open a copy of a file that is held in the macro cache
+	void SetMacroCacheExempt() noexcept { macroCacheExempt = true; }	// Don't invalidate the macro cache when this file is closed after writing
+#endif
 
 #if HAS_MASS_STORAGE || HAS_SBC_INTERFACE
 	FileWriteBuffer *GetWriteBuffer() const noexcept;			// Return a pointer to the remaining space for writing
@@ -113,7 +118,12 @@ private:
 	FileIndex fileIndex;
 #endif
 
-#if HAS_EMBEDDED_FILES || HAS_SBC_INTERFACE
+#if SUPPORT_MACRO_CACHE
+	CachedMacroFile *null cachedFile;							// the cache entry we are reading, or nullptr if we are not reading from the macro cache
+	bool macroCacheExempt;										// true if this file is never run as a macro, so writing it doesn't invalidate the macro cache
+#endif
+
+#if HAS_EMBEDDED_FILES || HAS_SBC_INTERFACE || SUPPORT_MACRO_CACHE
 	FilePosition offset;
 #endif
 
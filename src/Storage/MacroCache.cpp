@@ -0,0 +1,146 @@
+/*
+ * MacroCache.cpp
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include "MacroCache.h"
+
+#if SUPPORT_MACRO_CACHE
+
+#include "FileStore.h"
+#include <Platform/Platform.h>
+#include <Platform/RepRap.h>
+
+static Mutex cacheMutex;										// protects the cache entries, but not the change counter
+static CachedMacroFile entries[MacroCacheNumFiles];
+static volatile uint32_t changeCounter = 0;					// incremented whenever a file may have been changed, which invalidates all entries
+static unsigned int numHits = 0, numMisses = 0;
+
+void MacroCache::Init() noexcept
+{
+	cacheMutex.Create("MacroCache");
+	for (CachedMacroFile& cf : entries)
+	{
+		cf.data = nullptr;
+		cf.length = 0;
+		cf.generation = changeCounter - 1;					// mark the entry invalid
+		cf.whenLastUsed = 0;
+		cf.useCount = 0;
+	}
+}
+
+// Find a valid cached copy of the file and mark it as in use. The caller must call Release when it has finished with it.
+CachedMacroFile *MacroCache::Find(const char *_ecv_array filePath) noexcept
+{
+	MutexLocker lock(cacheMutex);
+	const uint32_t generation = changeCounter;
+	for (CachedMacroFile& cf : entries)
+	{
+		if (cf.generation == generation && StringEqualsIgnoreCase(cf.path.c_str(), filePath))		// FAT filenames are not case-sensitive
+		{
+			++cf.useCount;
+			cf.whenLastUsed = millis();
+			++numHits;
+			return &cf;
+		}
+	}
+	++numMisses;
+	return nullptr;
+}
+
+// Try to cache a file that has just been opened for reading. If successful, mark the entry as in use and return it; the caller should then close the file.
+// Otherwise return nullptr and leave the file positioned at the start.
+CachedMacroFile *MacroCache::Add(const char *_ecv_array filePath, FileStore& f) noexcept
+{
+	const FilePosition length = f.Length();
+	if (length > MacroCacheMaxFileSize || strlen(filePath) >= MaxFilenameLength)
+	{
+		return nullptr;
+	}
+
+	// Find the least recently used entry that isn't in use
+	MutexLocker lock(cacheMutex);
+	const uint32_t generation = changeCounter;				// read this before we read the file, so that if the file is changed while we read it then the entry is invalid
+	CachedMacroFile *_ecv_null replace = nullptr;
+	for (CachedMacroFile& cf : entries)
+	{
+		if (cf.useCount == 0)
+		{
+			if (cf.generation != generation)
+			{
+				replace = &cf;								// an invalid entry is always the best one to replace
+				break;
+			}
+			if (replace == nullptr || (int32_t)(cf.whenLastUsed - replace->whenLastUsed) < 0)
+			{
+				replace = &cf;
+			}
+		}
+	}
+	if (replace == nullptr)
+	{
+		return nullptr;										// all entries are in use
+	}
+
+	if (replace->data == nullptr)
+	{
+		replace->data = new char[MacroCacheMaxFileSize];	// we never free this, so it doesn't fragment the heap
+	}
+
+	replace->generation = generation - 1;					// mark it invalid until we have read the whole file
+	FilePosition bytesRead = 0;
+	while (bytesRead < length)
+	{
+		const int n = f.Read(replace->data + bytesRead, length - bytesRead);
+		if (n <= 0)
+		{
+			(void)f.Seek(0);
+			return nullptr;
+		}
+		bytesRead += (FilePosition)n;
+	}
+
+	replace->length = length;
+	replace->path.copy(filePath);
+	replace->generation = generation;
+	replace->whenLastUsed = millis();
+	replace->useCount = 1;
+	return replace;
+}
+
+void MacroCache::Release(CachedMacroFile *cf) noexcept
+{
+	MutexLocker lock(cacheMutex);
+	if (cf->useCount != 0)
+	{
+		--cf->useCount;
+	}
+}
+
+// Invalidate all entries. This doesn't lock the mutex, so it is safe to call it while holding other file system locks.
+void MacroCache::FilesChanged() noexcept
+{
+	changeCounter = changeCounter + 1;
+}
+
+void MacroCache::Diagnostics(MessageType mtype) noexcept
+{
+	unsigned int numValid = 0;
+	{
+		MutexLocker lock(cacheMutex);
+		for (const CachedMacroFile& cf : entries)
+		{
+			if (cf.generation == changeCounter)
+			{
+				++numValid;
+			}
+		}
+	}
+	reprap.GetPlatform().MessageF(mtype, "Macro cache: %u of %u entries valid, %u hits, %u misses\n", numValid, (unsigned int)MacroCacheNumFiles, numHits, numMisses);
+	numHits = numMisses = 0;
+}
+
+#endif
+
+// End
@@ -0,0 +1,43 @@
+/*
+ * MacroCache.h
+ *
+ *  Created on: 17 Oct 2026
+ *
+ * Cache of small macro files held in RAM, so that frequently run macros such as tool change files and daemon.g don't need to be read from the SD card every time.
+ * Rather than tracking which files have changed, the whole cache is invalidated whenever any file may have been written, deleted or renamed,
+ * or when a volume is mounted or unmounted. Those events are rare compared with running macros.
+ */
+
+#ifndef SRC_STORAGE_MACROCACHE_H_
+#define SRC_STORAGE_MACROCACHE_H_
+
+#include <RepRapFirmware.h>
+
+#if SUPPORT_MACRO_CACHE
+
+class FileStore;
+
+// An entry in the macro cache
+struct CachedMacroFile
+{
+	char *_ecv_array null data;							// buffer of MacroCacheMaxFileSize bytes, allocated when the entry is first used
+	FilePosition length;								// length of the file
+	uint32_t generation;								// the value of the change counter when we read the file
+	uint32_t whenLastUsed;								// when the file was last opened, used to decide which entry to replace
+	unsigned int useCount;								// the number of open FileStore objects that are reading this entry
+	String<MaxFilenameLength> path;
+};
+
+namespace MacroCache
+{
+	void Init() noexcept;
+	CachedMacroFile *null Find(const char *_ecv_array filePath) noexcept;		// find a valid cached copy of the file and mark it as in use
+	CachedMacroFile *null Add(const char *_ecv_array filePath, FileStore& f) noexcept;	// cache a file that has just been opened and mark it in use, returning nullptr if we can't
+	void Release(CachedMacroFile *cf) noexcept;								// called when a FileStore that was reading a cached file is closed
+	void FilesChanged() noexcept;											// called when a file may have been changed
+	void Diagnostics(MessageType mtype) noexcept;
+}
+
+#endif
+
+#endif /* SRC_STORAGE_MACROCACHE_H_ */
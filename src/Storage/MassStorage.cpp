@@ -3,6 +3,10 @@
 #include <Platform/RepRap.h>
 #include <ObjectModel/ObjectModel.h>
 
+#if SUPPORT_MACRO_CACHE
+# include "MacroCache.h"
+#endif
+
 #if HAS_MASS_STORAGE
 # include <Libraries/Fatfs/diskio.h>
 # include <Libraries/sd_mmc/sd_mmc.h>
@@ -256,6 +260,9 @@ static unsigned int InternalUnmount(size_t card, bool doClose) noexcept
 	MutexLocker lock1(fsMutex);
 	MutexLocker lock2(inf.volMutex);
 	const unsigned int invalidated = MassStorage::InvalidateFiles(&inf.fileSystem, doClose);
+#if SUPPORT_MACRO_CACHE
+	MacroCache::FilesChanged();											// a different card may be inserted
+#endif
 	const char path[3] = { (char)('0' + card), ':', 0 };
 	f_mount(nullptr, path, 0);
 	inf.Clear(card);
@@ -367,6 +374,10 @@ void MassStorage::Init() noexcept
 
 	// We no longer mount the SD card here because it may take a long time if it fails
 # endif
+
+# if SUPPORT_MACRO_CACHE
+	MacroCache::Init();
+# endif
 }
 
 
@@ -445,7 +456,7 @@ void MassStorage::Spin() noexcept
 	}
 }
 
-FileStore* MassStorage::OpenFile(const char* filePath, OpenMode mode, uint32_t preAllocSize) noexcept
+FileStore* MassStorage::OpenFile(const char* filePath, OpenMode mode, uint32_t preAllocSize, bool isMacroCacheExempt) noexcept
 {
 	{
 		MutexLocker lock(fsMutex);
@@ -459,6 +470,19 @@ FileStore* MassStorage::OpenFile(const char* filePath, OpenMode mode, uint32_t p
 				{
 					(void)VolumeUpdated(filePath);
 				}
+# endif
+# if SUPPORT_MACRO_CACHE
+				if (ret != nullptr && mode != OpenMode::read)
+				{
+					if (isMacroCacheExempt)
+					{
+						ret->SetMacroCacheExempt();
+					}
+					else
+					{
+						MacroCache::FilesChanged();
+					}
+				}
 # endif
 				return ret;
 			}
@@ -468,6 +492,49 @@ FileStore* MassStorage::OpenFile(const char* filePath, OpenMode mode, uint32_t p
 	return nullptr;
 }
 
+// Open a macro file for reading. If it is small enough, read it from the macro cache, adding it to the cache if it isn't there already.
+FileStore* MassStorage::OpenMacroFile(const char* filePath) noexcept
+{
+# if SUPPORT_MACRO_CACHE
+#  if HAS_SBC_INTERFACE
+	if (!reprap.UsingSbcInterface())
+#  endif
+	{
+		CachedMacroFile *cf = MacroCache::Find(filePath);
+		if (cf == nullptr)
+		{
+			FileStore * const f = OpenFile(filePath, OpenMode::read, 0);
+			if (f == nullptr)
+			{
+				return nullptr;
+			}
+			cf = MacroCache::Add(filePath, *f);
+			if (cf == nullptr)
+			{
+				return f;											// the file is too long to cache or the cache is full, so read it directly
+			}
+			f->Close();
+		}
+
+		{
+			MutexLocker lock(fsMutex);
+			for (FileStore& fil : files)
+			{
+				if (fil.IsFree())
+				{
+					fil.OpenCached(cf);
+					return &fil;
+				}
+			}
+		}
+		MacroCache::Release(cf);
+		reprap.GetPlatform().Message(ErrorMessage, "Max open file count exceeded.\n");
+		return nullptr;
+	}
+# endif
+	return OpenFile(filePath, OpenMode::read, 0);
+}
+
 // Close all files
 void MassStorage::CloseAllFiles() noexcept
 {
@@ -658,6 +725,9 @@ bool MassStorage::Delete(const char* filePath, bool messageIfFailed) noexcept
 	if (ok)
 	{
 		(void)VolumeUpdated(filePath);
+# if SUPPORT_MACRO_CACHE
+		MacroCache::FilesChanged();
+# endif
 	}
 	return ok;
 #else
@@ -884,6 +954,9 @@ bool MassStorage::Rename(const char *oldFilename, const char *newFilename, bool
 	{
 		(void)VolumeUpdated(newFilename);
 	}
+# if SUPPORT_MACRO_CACHE
+	MacroCache::FilesChanged();
+# endif
 	return true;
 }
 #endif
@@ -923,6 +996,18 @@ time_t MassStorage::GetLastModifiedTime(const char *filePath) noexcept
 	return 0;
 }
 
+bool MassStorage::GetFileSizeAndModifiedTime(const char *filePath, FilePosition& size, time_t& lastModified) noexcept
+{
+	FILINFO fil;
+	if (f_stat(filePath, &fil) == FR_OK && (fil.fattrib & AM_DIR) == 0)
+	{
+		size = fil.fsize;
+		lastModified = ConvertTimeStamp(fil.fdate, fil.ftime);
+		return true;
+	}
+	return false;
+}
+
 bool MassStorage::SetLastModifiedTime(const char *filePath, time_t time) noexcept
 {
 	tm timeInfo;
@@ -1154,6 +1239,13 @@ void MassStorage::Diagnostics(MessageType mtype) noexcept
 	platform.MessageF(mtype, "SD card longest read time %.1fms, write time %.1fms, max retries %u\n",
 								(double)DiskioGetAndClearLongestReadTime(), (double)DiskioGetAndClearLongestWriteTime(), DiskioGetAndClearMaxRetryCount());
 # endif
+
+# if SUPPORT_MACRO_CACHE
+	MacroCache::Diagnostics(mtype);
+# endif
+# if SUPPORT_FILE_INFO_CACHE
+	infoParser.Diagnostics(mtype);
+# endif
 }
 
 #endif
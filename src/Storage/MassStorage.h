@@ -43,7 +43,8 @@ namespace MassStorage
 
 #if HAS_MASS_STORAGE || HAS_SBC_INTERFACE || HAS_EMBEDDED_FILES
 	void Init() noexcept;
-	FileStore* OpenFile(const char* filePath, OpenMode mode, uint32_t preAllocSize) noexcept;
+	FileStore* OpenFile(const char* filePath, OpenMode mode, uint32_t preAllocSize, bool isMacroCacheExempt = false) noexcept;	// isMacroCacheExempt is true for files that are never run as macros
+	FileStore* OpenMacroFile(const char* filePath) noexcept;								// Open a file for reading, using the macro cache if possible
 	bool FileExists(const char *filePath) noexcept;
 	void CloseAllFiles() noexcept;
 	void Spin() noexcept;
@@ -86,6 +87,7 @@ namespace MassStorage
 	bool MakeDirectory(const char *_ecv_array directory, bool messageIfFailed) noexcept;
 	bool Rename(const char *_ecv_array oldFilePath, const char *_ecv_array newFilePath, bool deleteExisting, bool messageIfFailed) noexcept;
 	time_t GetLastModifiedTime(const char *_ecv_array filePath) noexcept;
+	bool GetFileSizeAndModifiedTime(const char *_ecv_array filePath, FilePosition& size, time_t& lastModified) noexcept;
 	bool SetLastModifiedTime(const char *_ecv_array file, time_t t) noexcept;
 	bool CheckDriveMounted(const char* path) noexcept;
 	bool IsCardDetected(size_t card) noexcept;